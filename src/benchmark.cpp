@@ -0,0 +1,353 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.h"
+
+//Internal
+#include "global.h"
+#include "tool_abstract.h"
+#include "model_jobList.h"
+#include "model_options.h"
+#include "model_sysinfo.h"
+#include "model_preferences.h"
+#include "job_descriptor.h"
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QThread>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QSemaphore>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QVector>
+#include <QUuid>
+#include <QScopedPointer>
+
+//CRT
+#include <climits>
+
+//Windows includes
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <Psapi.h>
+
+// ------------------------------------------------------------
+// Helper functions
+// ------------------------------------------------------------
+
+static qint64 PRIVATE_BYTES(void)
+{
+	PROCESS_MEMORY_COUNTERS_EX memoryCounters;
+	memset(&memoryCounters, 0, sizeof(PROCESS_MEMORY_COUNTERS_EX));
+	memoryCounters.cb = sizeof(PROCESS_MEMORY_COUNTERS_EX);
+	if(GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memoryCounters), sizeof(PROCESS_MEMORY_COUNTERS_EX)))
+	{
+		return qint64(memoryCounters.PrivateUsage);
+	}
+	return 0;
+}
+
+/*
+ * Enqueues jobs the same way as JobListModel::loadQueuedJobs() does, but without reading or writing the real queue.ini
+ */
+static bool FILL_QUEUE(JobListModel *const jobList, const OptionsModel *const options, const int &count, QVector<QUuid> *const jobIds = NULL)
+{
+	const QString tempPath = QDir::tempPath();
+	for(int i = 0; i < count; i++)
+	{
+		const JobDescriptor job(QString("%1/~benchmark_%2.avi").arg(tempPath, QString::number(i)), QString("%1/~benchmark_%2.mkv").arg(tempPath, QString::number(i)), options);
+		if(!jobList->insertJob(job, true).isValid())
+		{
+			return false;
+		}
+		if(jobIds)
+		{
+			jobIds->append(job.getId());
+		}
+	}
+	jobList->updateLookAhead();
+	return true;
+}
+
+// ------------------------------------------------------------
+// Helper classes
+// ------------------------------------------------------------
+
+/*
+ * Starts a trivial process as soon as the gate is opened, so that all starters compete for process creation
+ * at the same time, like jobs that are started simultaneously
+ */
+class ProcessStarter : public QThread
+{
+public:
+	ProcessStarter(QSemaphore &ready, QSemaphore &gate)
+	:
+		m_ready(ready),
+		m_gate(gate),
+		m_success(false),
+		m_latency(-1)
+	{
+	}
+
+	bool getSuccess(void) const { return m_success; }
+	qint64 getLatency(void) const { return m_latency; }
+
+protected:
+	virtual void run(void)
+	{
+		const QString program = QProcessEnvironment::systemEnvironment().value("ComSpec", "cmd.exe");
+		const QStringList args = QStringList() << "/c" << "exit";
+
+		QProcess process;
+		MUtils::init_process(process, QDir::tempPath(), true);
+
+		m_ready.release();
+		m_gate.acquire();
+
+		QElapsedTimer timer;
+		timer.start();
+
+		m_success = AbstractTool::launchProcess(process, program, args, NULL);
+		m_latency = timer.nsecsElapsed() / 1000I64;
+
+		if(!process.waitForFinished())
+		{
+			process.kill();
+			process.waitForFinished(-1);
+		}
+	}
+
+	QSemaphore &m_ready;
+	QSemaphore &m_gate;
+	volatile bool m_success;
+	volatile qint64 m_latency;
+};
+
+// ------------------------------------------------------------
+// Benchmarks
+// ------------------------------------------------------------
+
+const Benchmark::benchmark_t Benchmark::s_benchmarks[] =
+{
+	{ "process", Benchmark::benchmarkProcessStart },
+	{ "joblist", Benchmark::benchmarkJobListLoad  },
+	{ "jobstore", Benchmark::benchmarkJobStore    },
+	{ NULL, NULL }
+};
+
+/*
+ * Job start latency with N simultaneous starts. Note that process creation is still serialized by the start
+ * mutex (see AbstractTool::launchProcess), so the latency is expected to grow linearly with N; this measures
+ * how much a burst of job starts costs, it does not compare different locking strategies.
+ */
+bool Benchmark::benchmarkProcessStart(void)
+{
+	static const int COUNTS[] = { 1, 2, 4, 8, 16, 32, 0 };
+	static const int ROUNDS = 8;
+
+	for(int i = 0; COUNTS[i] > 0; i++)
+	{
+		qint64 latencyMin = LLONG_MAX, latencyMax = 0, latencySum = 0, wallSum = 0;
+		int samples = 0;
+
+		for(int round = 0; round < ROUNDS; round++)
+		{
+			QSemaphore ready, gate;
+			QList<ProcessStarter*> starters;
+			for(int k = 0; k < COUNTS[i]; k++)
+			{
+				starters << new ProcessStarter(ready, gate);
+				starters.last()->start();
+			}
+
+			ready.acquire(COUNTS[i]);
+			QElapsedTimer timer;
+			timer.start();
+			gate.release(COUNTS[i]);
+
+			bool success = true;
+			while(!starters.isEmpty())
+			{
+				ProcessStarter *starter = starters.takeFirst();
+				starter->wait();
+				if(starter->getSuccess())
+				{
+					latencyMin = qMin(latencyMin, starter->getLatency());
+					latencyMax = qMax(latencyMax, starter->getLatency());
+					latencySum += starter->getLatency();
+					samples++;
+				}
+				else
+				{
+					success = false;
+				}
+				MUTILS_DELETE(starter);
+			}
+
+			wallSum += timer.nsecsElapsed() / 1000I64;
+			if(!success)
+			{
+				qWarning("Process creation has failed!");
+				return false;
+			}
+		}
+
+		qDebug("process: %2d simultaneous starts -> latency min/avg/max = %lld/%lld/%lld usec, wall time = %lld usec", COUNTS[i], latencyMin, latencySum / qMax(samples, 1), latencyMax, wallSum / ROUNDS);
+	}
+
+	return true;
+}
+
+/*
+ * Load time and memory of a queue with 10k and 100k enqueued jobs, the source files do not need to exist
+ */
+bool Benchmark::benchmarkJobListLoad(void)
+{
+	static const int COUNTS[] = { 10000, 100000, 0 };
+
+	SysinfoModel sysinfo;
+	PreferencesModel preferences;
+	const OptionsModel options(&sysinfo);
+
+	for(int i = 0; COUNTS[i] > 0; i++)
+	{
+		const qint64 memoryBefore = PRIVATE_BYTES();
+		QElapsedTimer timer;
+		timer.start();
+
+		JobListModel *jobList = new JobListModel(&preferences, &sysinfo);
+		const bool success = FILL_QUEUE(jobList, &options, COUNTS[i]);
+		const qint64 loadTime = timer.elapsed();
+		const qint64 memoryUsed = PRIVATE_BYTES() - memoryBefore;
+		MUTILS_DELETE(jobList);
+
+		if(!success)
+		{
+			qWarning("Failed to enqueue the jobs!");
+			return false;
+		}
+
+		qDebug("joblist: %6d queued jobs -> load time = %lld msec, memory = %lld KiB (%lld bytes per job)", COUNTS[i], loadTime, memoryUsed / 1024I64, memoryUsed / qint64(COUNTS[i]));
+	}
+
+	return true;
+}
+
+/*
+ * Throughput of the job store with 100k rows: insert, update by job id and query by job id
+ */
+bool Benchmark::benchmarkJobStore(void)
+{
+	static const int COUNT = 100000;
+
+	SysinfoModel sysinfo;
+	PreferencesModel preferences;
+	const OptionsModel options(&sysinfo);
+	QScopedPointer<JobListModel> jobList(new JobListModel(&preferences, &sysinfo));
+	QVector<QUuid> jobIds;
+	jobIds.reserve(COUNT);
+
+	QElapsedTimer timer;
+	timer.start();
+	if(!FILL_QUEUE(jobList.data(), &options, COUNT, &jobIds))
+	{
+		qWarning("Failed to enqueue the jobs!");
+		return false;
+	}
+	const qint64 insertTime = qMax(timer.restart(), 1I64);
+
+	//Updates arrive by job id, like the signals of running jobs
+	for(int i = 0; i < COUNT; i++)
+	{
+		jobList->updateProgress(jobIds.at(i), static_cast<unsigned int>(i % 100));
+		jobList->updateDetails(jobIds.at(i), QString("Benchmark update #%1").arg(QString::number(i)));
+	}
+	const qint64 updateTime = qMax(timer.restart(), 1I64);
+
+	//Queries look up the row by job id first, then read every column like the view does
+	const int columns = jobList->columnCount(QModelIndex());
+	qint64 checksum = 0;
+	for(int i = COUNT - 1; i >= 0; i--)
+	{
+		const QModelIndex index = jobList->getJobIndexById(jobIds.at(i));
+		if(!index.isValid())
+		{
+			qWarning("Job not found!");
+			return false;
+		}
+		checksum += jobList->getJobProgress(index);
+		for(int column = 0; column < columns; column++)
+		{
+			checksum += jobList->data(jobList->index(index.row(), column, QModelIndex()), Qt::DisplayRole).toString().length();
+		}
+	}
+	const qint64 queryTime = qMax(timer.elapsed(), 1I64);
+
+	qDebug("jobstore: %d rows -> insert = %lld msec (%lld rows/sec)", COUNT, insertTime, (qint64(COUNT) * 1000I64) / insertTime);
+	qDebug("jobstore: %d rows -> update = %lld msec (%lld updates/sec)", COUNT, updateTime, (qint64(COUNT) * 2000I64) / updateTime);
+	qDebug("jobstore: %d rows -> query  = %lld msec (%lld queries/sec, checksum %lld)", COUNT, queryTime, (qint64(COUNT) * 1000I64) / queryTime, checksum);
+
+	return true;
+}
+
+// ------------------------------------------------------------
+// Harness
+// ------------------------------------------------------------
+
+int Benchmark::run(const QStringList &names)
+{
+	QStringList selected;
+	foreach(const QString &name, names)
+	{
+		if(!name.trimmed().isEmpty())
+		{
+			selected << name.trimmed().toLower();
+		}
+	}
+
+	int failed = 0, executed = 0;
+	for(size_t i = 0; s_benchmarks[i].name; i++)
+	{
+		if(selected.isEmpty() || selected.contains(QString::fromLatin1(s_benchmarks[i].name)))
+		{
+			qDebug("Running benchmark \"%s\"...", s_benchmarks[i].name);
+			QElapsedTimer timer;
+			timer.start();
+			const bool success = s_benchmarks[i].func();
+			qDebug("Benchmark \"%s\" %s after %lld msec.\n", s_benchmarks[i].name, success ? "completed" : "FAILED", timer.elapsed());
+			if(!success) failed++;
+			executed++;
+		}
+	}
+
+	if(executed < 1)
+	{
+		qWarning("No matching benchmark found!");
+		return EXIT_FAILURE;
+	}
+
+	return (failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
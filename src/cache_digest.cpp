@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "cache_digest.h"
+
+#include "cache_file.h"
+
+#include <QStringList>
+#include <QMutex>
+#include <QAtomicInt>
+
+static FileCache g_digestCache("digests");
+static QMutex g_digestLock;
+static QAtomicInt g_fullVerification;
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+bool DigestCache::lookup(const QString &filePath, const QString &method, QByteArray &digest)
+{
+	if(getFullVerification())
+	{
+		return false; /*always re-compute*/
+	}
+
+	QVariant value;
+	if(g_digestCache.lookup(QStringList() << filePath, value))
+	{
+		const QString prefix = QString("%1:").arg(method);
+		const QStringList records = value.toStringList();
+		for(QStringList::ConstIterator iter = records.constBegin(); iter != records.constEnd(); iter++)
+		{
+			if(iter->startsWith(prefix))
+			{
+				digest = iter->mid(prefix.length()).toLatin1();
+				return (!digest.isEmpty());
+			}
+		}
+	}
+	return false;
+}
+
+void DigestCache::store(const QString &filePath, const QString &method, const QByteArray &digest)
+{
+	const QStringList files = QStringList() << filePath;
+	const QString prefix = QString("%1:").arg(method);
+	QMutexLocker lock(&g_digestLock);
+
+	QStringList records;
+	QVariant value;
+	if(g_digestCache.lookup(files, value))
+	{
+		records = value.toStringList();
+		for(QStringList::Iterator iter = records.begin(); iter != records.end();)
+		{
+			iter = iter->startsWith(prefix) ? records.erase(iter) : (iter + 1);
+		}
+	}
+
+	records << QString("%1%2").arg(prefix, QString::fromLatin1(digest.constData(), digest.size()));
+	g_digestCache.store(files, records);
+}
+
+void DigestCache::setFullVerification(const bool &enable)
+{
+	g_fullVerification.fetchAndStoreOrdered(enable ? 1 : 0);
+}
+
+bool DigestCache::getFullVerification(void)
+{
+	return (g_fullVerification != 0);
+}
@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "cache_file.h"
+
+#include "global.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QCryptographicHash>
+
+static const char *KEY_IDENTITY = "identity";
+static const char *KEY_DEPENDS  = "dependencies";
+static const char *KEY_VALUE    = "value";
+static const char *KEY_BUILDNUM = "launcher_build";
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor
+///////////////////////////////////////////////////////////////////////////////
+
+FileCache::FileCache(const QString &name)
+:
+	m_name(name)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+bool FileCache::lookup(const QStringList &files, QVariant &value)
+{
+	const QString key = makeKey(files);
+	QMutexLocker lock(&m_mutex);
+
+	if(!m_entries.contains(key))
+	{
+		QSettings settings(getCacheFile(), QSettings::IniFormat);
+		settings.beginGroup(key);
+		if(settings.value(KEY_BUILDNUM, 0U).toUInt() != x264_version_build())
+		{
+			return false; /*missing or written by a different launcher build*/
+		}
+		entry_t entry;
+		entry.identity = settings.value(KEY_IDENTITY).toString();
+		entry.dependencies = settings.value(KEY_DEPENDS).toStringList();
+		entry.value = settings.value(KEY_VALUE);
+		if(entry.identity.isEmpty() || (!entry.value.isValid()))
+		{
+			return false;
+		}
+		m_entries.insert(key, entry);
+	}
+
+	const entry_t &entry = m_entries[key];
+	const QString identity = makeIdentity(QStringList() << files << entry.dependencies);
+	if(identity.isEmpty() || (entry.identity.compare(identity) != 0))
+	{
+		m_entries.remove(key); /*files have changed*/
+		return false;
+	}
+
+	value = entry.value;
+	return true;
+}
+
+void FileCache::store(const QStringList &files, const QVariant &value, const QStringList &dependencies)
+{
+	entry_t entry;
+	entry.identity = makeIdentity(QStringList() << files << dependencies);
+	entry.dependencies = dependencies;
+	entry.value = value;
+
+	if(entry.identity.isEmpty() || (!entry.value.isValid()))
+	{
+		return;
+	}
+
+	const QString key = makeKey(files);
+	QMutexLocker lock(&m_mutex);
+	m_entries.insert(key, entry);
+
+	QSettings settings(getCacheFile(), QSettings::IniFormat);
+	if(settings.isWritable())
+	{
+		settings.beginGroup(key);
+		settings.setValue(KEY_IDENTITY, entry.identity);
+		settings.setValue(KEY_DEPENDS,  entry.dependencies);
+		settings.setValue(KEY_VALUE,    entry.value);
+		settings.setValue(KEY_BUILDNUM, x264_version_build());
+		settings.endGroup();
+		settings.sync();
+	}
+	else
+	{
+		qWarning("Cache file is not writable: %s", getCacheFile().toUtf8().constData());
+	}
+}
+
+QString FileCache::makeIdentity(const QStringList &files)
+{
+	QStringList identities;
+	for(QStringList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		const QString identity = x264_file_identity(*iter);
+		if(identity.isEmpty())
+		{
+			return QString(); /*file not accessible*/
+		}
+		identities << identity;
+	}
+	return identities.join("|");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal Functions
+///////////////////////////////////////////////////////////////////////////////
+
+QString FileCache::makeKey(const QStringList &files)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	for(QStringList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		hash.addData(QDir::fromNativeSeparators(QFileInfo(*iter).absoluteFilePath()).toLower().toUtf8());
+		hash.addData("\n", 1);
+	}
+	return QString::fromLatin1(hash.result().toHex().constData());
+}
+
+QString FileCache::getCacheFile(void) const
+{
+	return QString("%1/%2.ini").arg(x264_data_path(), m_name);
+}
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QHash>
+#include <QMutex>
+
+class FileCache
+{
+public:
+	FileCache(const QString &name);
+
+	bool lookup(const QStringList &files, QVariant &value);
+	void store(const QStringList &files, const QVariant &value, const QStringList &dependencies = QStringList());
+
+	static QString makeIdentity(const QStringList &files);
+
+protected:
+	typedef struct
+	{
+		QString identity;
+		QStringList dependencies;
+		QVariant value;
+	}
+	entry_t;
+
+	static QString makeKey(const QStringList &files);
+	QString getCacheFile(void) const;
+
+	const QString m_name;
+	QMutex m_mutex;
+	QHash<QString, entry_t> m_entries;
+};
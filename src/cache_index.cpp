@@ -0,0 +1,242 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "cache_index.h"
+
+#include "global.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSettings>
+#include <QStringList>
+#include <QMap>
+#include <QCryptographicHash>
+
+static const char *KEY_LASTUSED = "last_used";
+
+//Size and number of the chunks that are sampled from the source file
+static const qint64 SAMPLE_SIZE  = 65536;
+static const int    SAMPLE_COUNT = 3;
+
+//Overall size budget of the cache directory
+static const qint64 MAX_CACHE_SIZE = Q_INT64_C(536870912);
+
+static inline QString LOCK_KEY(const QString &indexFile)
+{
+	return QDir::fromNativeSeparators(QFileInfo(indexFile).absoluteFilePath()).toLower();
+}
+
+QMutex                  IndexCache::s_mutex;
+QWaitCondition          IndexCache::s_unlocked;
+QSet<QString>           IndexCache::s_locked;
+QHash<QString, QString> IndexCache::s_keys;
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+QString IndexCache::getIndexFile(const QString &sourceFile)
+{
+	const QString key = makeKey(sourceFile);
+	if(key.isEmpty())
+	{
+		return QString();
+	}
+
+	const QString cacheDir = getCacheDir();
+	if(!QDir(cacheDir).exists())
+	{
+		if(!QDir().mkpath(cacheDir))
+		{
+			qWarning("Failed to create cache directory: %s", cacheDir.toUtf8().constData());
+			return QString();
+		}
+	}
+
+	return QString("%1/%2.ffindex").arg(cacheDir, key);
+}
+
+QString IndexCache::getTempFile(const QString &indexFile)
+{
+	return QString("%1.tmp").arg(indexFile);
+}
+
+bool IndexCache::tryLock(const QString &indexFile)
+{
+	QMutexLocker lock(&s_mutex);
+	const QString key = LOCK_KEY(indexFile);
+
+	if(s_locked.contains(key))
+	{
+		return false;
+	}
+
+	s_locked.insert(key);
+	return true;
+}
+
+bool IndexCache::lock(const QString &indexFile, volatile bool *abort)
+{
+	QMutexLocker lock(&s_mutex);
+	const QString key = LOCK_KEY(indexFile);
+
+	while(s_locked.contains(key))
+	{
+		if(abort && (*abort))
+		{
+			return false;
+		}
+		s_unlocked.wait(&s_mutex, 1000);
+	}
+
+	s_locked.insert(key);
+	return true;
+}
+
+void IndexCache::unlock(const QString &indexFile)
+{
+	QMutexLocker lock(&s_mutex);
+	s_locked.remove(LOCK_KEY(indexFile));
+	s_unlocked.wakeAll();
+}
+
+void IndexCache::touch(const QString &indexFile)
+{
+	QMutexLocker lock(&s_mutex);
+	const QFileInfo info(indexFile);
+
+	if(info.exists() && (info.absolutePath().compare(QFileInfo(getCacheDir()).absoluteFilePath(), Qt::CaseInsensitive) == 0))
+	{
+		QSettings index(QString("%1/index.ini").arg(getCacheDir()), QSettings::IniFormat);
+		index.setValue(QString("%1/%2").arg(info.completeBaseName(), KEY_LASTUSED), QDateTime::currentMSecsSinceEpoch());
+		index.sync();
+		evict();
+	}
+}
+
+/*
+ * Temporary files are left behind, if the application was terminated while an index was being created
+ */
+void IndexCache::removeStaleTempFiles(void)
+{
+	QMutexLocker lock(&s_mutex);
+	const QString cacheDir = getCacheDir();
+
+	const QFileInfoList files = QDir(cacheDir).entryInfoList(QStringList() << "*.ffindex.tmp", QDir::Files);
+	for(QFileInfoList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		const QString indexFile = QString("%1/%2").arg(cacheDir, iter->completeBaseName());
+		if(!s_locked.contains(LOCK_KEY(indexFile)))
+		{
+			qWarning("Removing stale temporary index file: %s", iter->fileName().toUtf8().constData());
+			QFile::remove(iter->absoluteFilePath());
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal Functions
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The key is derived from the file's content (size, time stamp and sampled data), not from its path
+ */
+QString IndexCache::makeKey(const QString &sourceFile)
+{
+	const QString identity = x264_file_identity(sourceFile);
+	if(identity.isEmpty())
+	{
+		return QString();
+	}
+
+	{
+		QMutexLocker lock(&s_mutex);
+		if(s_keys.contains(identity))
+		{
+			return s_keys.value(identity);
+		}
+	}
+
+	QFile file(sourceFile);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return QString();
+	}
+
+	const qint64 size = file.size();
+	const QDateTime modified = QFileInfo(file).lastModified().toUTC();
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(QString("%1:%2").arg(QString::number(size), QString::number(modified.toMSecsSinceEpoch())).toLatin1());
+	for(int i = 0; i < SAMPLE_COUNT; i++)
+	{
+		const qint64 offset = (SAMPLE_COUNT > 1) ? (qMax(size - SAMPLE_SIZE, Q_INT64_C(0)) * i / (SAMPLE_COUNT - 1)) : 0;
+		if(file.seek(offset))
+		{
+			hash.addData(file.read(SAMPLE_SIZE));
+		}
+	}
+
+	const QString key = QString::fromLatin1(hash.result().toHex().constData());
+
+	QMutexLocker lock(&s_mutex);
+	s_keys.insert(identity, key);
+	return key;
+}
+
+void IndexCache::evict(void)
+{
+	const QString cacheDir = getCacheDir();
+	QSettings index(QString("%1/index.ini").arg(cacheDir), QSettings::IniFormat);
+
+	QMultiMap<qint64, QString> entries;
+	qint64 totalSize = 0;
+
+	const QFileInfoList files = QDir(cacheDir).entryInfoList(QStringList() << "*.ffindex", QDir::Files);
+	for(QFileInfoList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		entries.insert(index.value(QString("%1/%2").arg(iter->completeBaseName(), KEY_LASTUSED), 0).toLongLong(), iter->absoluteFilePath());
+		totalSize += iter->size();
+	}
+
+	//Remove the least recently used index files, but never one that is in use
+	for(QMultiMap<qint64, QString>::ConstIterator iter = entries.constBegin(); (iter != entries.constEnd()) && (totalSize > MAX_CACHE_SIZE); iter++)
+	{
+		if(s_locked.contains(LOCK_KEY(iter.value())))
+		{
+			continue;
+		}
+		const QFileInfo info(iter.value());
+		if(QFile::remove(iter.value()))
+		{
+			totalSize -= info.size();
+			index.remove(info.completeBaseName());
+		}
+	}
+}
+
+QString IndexCache::getCacheDir(void)
+{
+	return QString("%1/index").arg(x264_data_path());
+}
@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QSet>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+
+class IndexCache
+{
+public:
+	static QString getIndexFile(const QString &sourceFile);
+	static QString getTempFile(const QString &indexFile);
+
+	static bool tryLock(const QString &indexFile);
+	static bool lock(const QString &indexFile, volatile bool *abort);
+	static void unlock(const QString &indexFile);
+
+	static void touch(const QString &indexFile);
+	static void removeStaleTempFiles(void);
+
+protected:
+	static QString makeKey(const QString &sourceFile);
+	static void evict(void);
+	static QString getCacheDir(void);
+
+	static QMutex s_mutex;
+	static QWaitCondition s_unlocked;
+	static QSet<QString> s_locked;
+	static QHash<QString, QString> s_keys;
+};
@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "cache_stats.h"
+
+#include "global.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSettings>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+static const char *KEY_SUFFIXES = "files";
+static const char *KEY_SIZE     = "size";
+static const char *KEY_LASTUSED = "last_used";
+
+//Side files written by x264 (mbtree) and x265 (cutree) next to the stats file
+static const char *const SIDE_FILES[] = { "", ".mbtree", ".cutree", NULL };
+
+//Overall size budget of the cache directory
+static const qint64 MAX_CACHE_SIZE = Q_INT64_C(1073741824);
+
+QMutex StatsCache::s_mutex;
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+QString StatsCache::makeKey(const QStringList &files, const QStringList &params)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	for(QStringList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		const QString identity = x264_file_identity(*iter);
+		if(identity.isEmpty())
+		{
+			return QString(); /*file not accessible*/
+		}
+		hash.addData(QDir::fromNativeSeparators(QFileInfo(*iter).absoluteFilePath()).toLower().toUtf8());
+		hash.addData("\n", 1);
+		hash.addData(identity.toLatin1());
+		hash.addData("\n", 1);
+	}
+	for(QStringList::ConstIterator iter = params.constBegin(); iter != params.constEnd(); iter++)
+	{
+		hash.addData(iter->toUtf8());
+		hash.addData("\n", 1);
+	}
+	return QString::fromLatin1(hash.result().toHex().constData());
+}
+
+bool StatsCache::restore(const QString &key, const QString &passLogFile)
+{
+	QMutexLocker lock(&s_mutex);
+
+	const QString cacheDir = getCacheDir();
+	QSettings index(QString("%1/index.ini").arg(cacheDir), QSettings::IniFormat);
+	if(!index.childGroups().contains(key))
+	{
+		return false;
+	}
+
+	index.beginGroup(key);
+	const QStringList suffixes = index.value(KEY_SUFFIXES).toStringList();
+	const qint64 expectedSize = index.value(KEY_SIZE, -1).toLongLong();
+	index.endGroup();
+
+	//Make sure the cached files are still complete
+	qint64 totalSize = 0;
+	for(QStringList::ConstIterator iter = suffixes.constBegin(); iter != suffixes.constEnd(); iter++)
+	{
+		totalSize += QFileInfo(QString("%1/%2.stats%3").arg(cacheDir, key, *iter)).size();
+	}
+	if(suffixes.isEmpty() || (totalSize != expectedSize))
+	{
+		qWarning("Cached pass-1 statistics are incomplete, discarding!");
+		for(int i = 0; SIDE_FILES[i]; i++)
+		{
+			QFile::remove(QString("%1/%2.stats%3").arg(cacheDir, key, QString::fromLatin1(SIDE_FILES[i])));
+		}
+		index.remove(key);
+		return false;
+	}
+
+	for(QStringList::ConstIterator iter = suffixes.constBegin(); iter != suffixes.constEnd(); iter++)
+	{
+		const QString targetFile = QString("%1%2").arg(passLogFile, *iter);
+		if(!QFile::copy(QString("%1/%2.stats%3").arg(cacheDir, key, *iter), targetFile))
+		{
+			qWarning("Failed to restore cached pass-1 statistics: %s", targetFile.toUtf8().constData());
+			for(QStringList::ConstIterator undo = suffixes.constBegin(); undo != iter; undo++)
+			{
+				QFile::remove(QString("%1%2").arg(passLogFile, *undo));
+			}
+			return false;
+		}
+	}
+
+	index.setValue(QString("%1/%2").arg(key, KEY_LASTUSED), QDateTime::currentMSecsSinceEpoch());
+	index.sync();
+	return true;
+}
+
+void StatsCache::store(const QString &key, const QString &passLogFile)
+{
+	QStringList suffixes;
+	qint64 totalSize = 0;
+	for(int i = 0; SIDE_FILES[i]; i++)
+	{
+		const QFileInfo info(QString("%1%2").arg(passLogFile, QString::fromLatin1(SIDE_FILES[i])));
+		if(info.exists() && info.isFile())
+		{
+			suffixes << QString::fromLatin1(SIDE_FILES[i]);
+			totalSize += info.size();
+		}
+	}
+
+	if(suffixes.isEmpty() || (!suffixes.first().isEmpty()) || (totalSize > MAX_CACHE_SIZE))
+	{
+		return; /*no stats file or too big to be cached*/
+	}
+
+	QMutexLocker lock(&s_mutex);
+
+	const QString cacheDir = getCacheDir();
+	if(!QDir(cacheDir).exists())
+	{
+		if(!QDir().mkpath(cacheDir))
+		{
+			qWarning("Failed to create cache directory: %s", cacheDir.toUtf8().constData());
+			return;
+		}
+	}
+
+	QSettings index(QString("%1/index.ini").arg(cacheDir), QSettings::IniFormat);
+	evict(index, MAX_CACHE_SIZE - totalSize);
+
+	for(QStringList::ConstIterator iter = suffixes.constBegin(); iter != suffixes.constEnd(); iter++)
+	{
+		const QString targetFile = QString("%1/%2.stats%3").arg(cacheDir, key, *iter);
+		QFile::remove(targetFile);
+		if(!QFile::copy(QString("%1%2").arg(passLogFile, *iter), targetFile))
+		{
+			qWarning("Failed to cache pass-1 statistics: %s", targetFile.toUtf8().constData());
+			for(QStringList::ConstIterator undo = suffixes.constBegin(); undo != iter; undo++)
+			{
+				QFile::remove(QString("%1/%2.stats%3").arg(cacheDir, key, *undo));
+			}
+			return;
+		}
+	}
+
+	index.beginGroup(key);
+	index.setValue(KEY_SUFFIXES, suffixes);
+	index.setValue(KEY_SIZE,     totalSize);
+	index.setValue(KEY_LASTUSED, QDateTime::currentMSecsSinceEpoch());
+	index.endGroup();
+	index.sync();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal Functions
+///////////////////////////////////////////////////////////////////////////////
+
+void StatsCache::evict(QSettings &index, const qint64 &budget)
+{
+	QMultiMap<qint64, QString> entries;
+	qint64 totalSize = 0;
+
+	const QStringList keys = index.childGroups();
+	for(QStringList::ConstIterator iter = keys.constBegin(); iter != keys.constEnd(); iter++)
+	{
+		index.beginGroup(*iter);
+		entries.insert(index.value(KEY_LASTUSED, 0).toLongLong(), *iter);
+		totalSize += index.value(KEY_SIZE, 0).toLongLong();
+		index.endGroup();
+	}
+
+	//Remove the least recently used entries until we are within budget
+	const QString cacheDir = getCacheDir();
+	for(QMultiMap<qint64, QString>::ConstIterator iter = entries.constBegin(); (iter != entries.constEnd()) && (totalSize > budget); iter++)
+	{
+		totalSize -= index.value(QString("%1/%2").arg(iter.value(), KEY_SIZE), 0).toLongLong();
+		for(int i = 0; SIDE_FILES[i]; i++)
+		{
+			QFile::remove(QString("%1/%2.stats%3").arg(cacheDir, iter.value(), QString::fromLatin1(SIDE_FILES[i])));
+		}
+		index.remove(iter.value());
+	}
+}
+
+QString StatsCache::getCacheDir(void)
+{
+	return QString("%1/stats").arg(x264_data_path());
+}
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "cache_version.h"
+
+#include "cache_file.h"
+
+#include <climits>
+
+static FileCache g_versionCache("versions");
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+bool VersionCache::lookup(const QStringList &files, unsigned int &revision, bool &modified)
+{
+	QVariant value;
+	if(g_versionCache.lookup(files, value))
+	{
+		bool ok = false;
+		const qulonglong data = value.toULongLong(&ok);
+		if(ok && (quint32(data) != UINT_MAX))
+		{
+			revision = quint32(data);
+			modified = ((data >> 32) != 0);
+			return true;
+		}
+	}
+	return false;
+}
+
+void VersionCache::store(const QStringList &files, const unsigned int &revision, const bool &modified)
+{
+	if(revision != UINT_MAX)
+	{
+		const qulonglong data = (qulonglong(modified ? 1U : 0U) << 32) | qulonglong(revision);
+		g_versionCache.store(files, data);
+	}
+}
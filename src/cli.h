@@ -34,12 +34,14 @@ static const char *const CLI_PARAM_FORCE_ENQUEUE      = "force-enqueue";
 static const char *const CLI_PARAM_SKIP_AVS_CHECK     = "skip-avisynth-check";
 static const char *const CLI_PARAM_SKIP_VPS_CHECK     = "skip-vapoursynth-check";
 static const char *const CLI_PARAM_SKIP_VERSION_CHECK = "skip-version-checks";
+static const char *const CLI_PARAM_FULL_VERIFICATION  = "full-verification";
 static const char *const CLI_PARAM_NO_DEADLOCK        = "no-deadlock-detection";
 static const char *const CLI_PARAM_NO_GUI_STYLE       = "no-style";
 static const char* const CLI_PARAM_DARK_GUI_MODE      = "dark-gui-mode";
 static const char *const CLI_PARAM_FIRST_RUN          = "first-run";
 static const char *const CLI_PARAM_CONSOLE_SHOW       = "console";
 static const char *const CLI_PARAM_CONSOLE_HIDE       = "no-console";
+static const char *const CLI_PARAM_BENCHMARK          = "benchmark";
 static const char *const CLI_PARAM_CPU_NO_64BIT       = "force-cpu-no-64bit";
 static const char *const CLI_PARAM_CPU_NO_SSE         = "force-cpu-no-sse";
 static const char *const CLI_PARAM_CPU_NO_INTEL       = "force-cpu-no-intel";
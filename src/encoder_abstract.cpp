@@ -28,6 +28,11 @@
 #include "model_sysinfo.h"
 #include "model_status.h"
 #include "source_abstract.h"
+#include "job_object.h"
+#include "job_watchdog.h"
+#include "encoder_schema.h"
+#include "cache_index.h"
+#include "job_render.h"
 
 //MUtils
 #include <MUtils/Global.h>
@@ -44,6 +49,25 @@
 #include <QThread>
 #include <QLocale>
 
+/*
+ * Release the index file when the encoding pass is done
+ */
+class IndexLocker
+{
+public:
+	IndexLocker(const QString &indexFile) : m_indexFile(indexFile) {}
+	~IndexLocker(void)
+	{
+		if(!m_indexFile.isEmpty())
+		{
+			IndexCache::unlock(m_indexFile);
+			IndexCache::touch(m_indexFile);
+		}
+	}
+private:
+	const QString m_indexFile;
+};
+
 // ------------------------------------------------------------
 // Constructor & Destructor
 // ------------------------------------------------------------
@@ -53,7 +77,8 @@ AbstractEncoder::AbstractEncoder(JobObject *jobObject, const OptionsModel *optio
 	AbstractTool(jobObject, options, sysinfo, preferences, jobStatus, abort, pause, semaphorePause),
 	m_sourceFile(sourceFile),
 	m_outputFile(outputFile),
-	m_indexFile(QString("%1/~%2.ffindex").arg(QDir::tempPath(), stringToHash(m_sourceFile)))
+	m_indexFile(makeIndexFile(m_sourceFile)),
+	m_inputFile(sourceFile)
 {
 	/*Nothing to do here*/
 }
@@ -63,19 +88,67 @@ AbstractEncoder::~AbstractEncoder(void)
 	/*Nothing to do here*/
 }
 
+// ------------------------------------------------------------
+// Check Custom Parameters
+// ------------------------------------------------------------
+
+void AbstractEncoder::checkCustomParams(void)
+{
+	const QString customParams = m_options->customEncParams().trimmed();
+	if(customParams.isEmpty())
+	{
+		return;
+	}
+
+	const QSharedPointer<const EncoderSchema> schema = EncoderSchema::build(getBinaryPath(), getEncoderInfo().getHelpCommand());
+	if(schema.isNull())
+	{
+		log(tr("Warning: Supported encoder options are unknown, custom parameters can not be validated!"));
+		return;
+	}
+
+	//The schema is parsed from the help text, so it may be wrong; leave the final decision to the encoder
+	QString error;
+	if(!schema->validate(splitParams(customParams, m_sourceFile, m_outputFile), error))
+	{
+		log(tr("Warning: Custom parameters might not be supported by the encoder: %1").arg(error));
+	}
+}
+
 // ------------------------------------------------------------
 // Encoding Functions
 // ------------------------------------------------------------
 
-bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString outputFile, const ClipInfo &clipInfo, const int &pass, const QString &passLogFile)
+bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString outputFile, const ClipInfo &clipInfo, const int &pass, const QString &passLogFile, RenderSpool *const renderSpool)
 {
 	QProcess processEncode, processInput;
 	
-	if(pipedSource)
+	//Input may have been rendered ahead already
+	RenderSpool *const inputSpool = (pipedSource && renderSpool && renderSpool->attach()) ? renderSpool : NULL;
+	bool endOfInput = false;
+
+	if(inputSpool)
+	{
+		log(tr("Reading input from render-ahead spool:"));
+		log(commandline2string(inputSpool->getProgram(), inputSpool->getArgs()) + "\n");
+	}
+	else if(pipedSource)
 	{
 		pipedSource->createProcess(processEncode, processInput);
 	}
 
+	//The index file may currently be created by the background indexer
+	const QString indexFile = pipedSource ? QString() : m_indexFile;
+	if((!indexFile.isEmpty()) && (!IndexCache::tryLock(indexFile)))
+	{
+		log(tr("Waiting for background indexing to complete...\n"));
+		if(!IndexCache::lock(indexFile, m_abort))
+		{
+			return false;
+		}
+	}
+	IndexLocker indexLocker(indexFile);
+
 	QStringList cmdLine_Encode;
 	buildCommandLine(cmdLine_Encode, (pipedSource != NULL), clipInfo, m_indexFile, pass, passLogFile);
 
@@ -94,14 +167,19 @@ bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString
 	bool bTimeout = false;
 	bool bAborted = false;
 
+	//Watch for progress of the whole job
+	JobWatchdog watchdog(m_jobObject, QStringList() << m_outputFile << passLogFile, m_processTimeoutInterval, m_processTimeoutWarning, m_processTimeoutMaxCounter);
+
 	//Main processing loop
 	while(processEncode.state() != QProcess::NotRunning)
 	{
-		unsigned int waitCounter = 0;
-
 		//Wait until new output is available
 		forever
 		{
+			if(inputSpool)
+			{
+				runEncodingPass_feedInput(processEncode, inputSpool, endOfInput);
+			}
 			if(*m_abort)
 			{
 				processEncode.kill();
@@ -114,38 +192,24 @@ bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString
 				JobStatus previousStatus = m_jobStatus;
 				setStatus(JobStatus_Paused);
 				log(tr("Job paused by user at %1, %2.").arg(QDate::currentDate().toString(Qt::ISODate), QTime::currentTime().toString( Qt::ISODate)));
-				bool ok[2] = {false, false};
-				QProcess *proc[2] = { &processEncode, &processInput };
-				ok[0] = MUtils::OS::suspend_process(proc[0], true);
-				ok[1] = MUtils::OS::suspend_process(proc[1], true);
-				while(*m_pause) m_semaphorePause->tryAcquire(1, 5000);
+				m_jobObject->suspendJob(true);
+				while(*m_pause) m_semaphorePause->acquire();
 				while(m_semaphorePause->tryAcquire(1, 0));
-				ok[0] = MUtils::OS::suspend_process(proc[0], false);
-				ok[1] = MUtils::OS::suspend_process(proc[1], false);
+				m_jobObject->suspendJob(false);
 				if(!(*m_abort)) setStatus(previousStatus);
 				log(tr("Job resumed by user at %1, %2.").arg(QDate::currentDate().toString(Qt::ISODate), QTime::currentTime().toString( Qt::ISODate)));
-				waitCounter = 0;
+				watchdog.reset();
 				continue;
 			}
-			if(!processEncode.waitForReadyRead(m_processTimeoutInterval))
+			if(!processEncode.waitForReadyRead(inputSpool ? m_feedInterval : m_processTimeoutInterval))
 			{
 				if(processEncode.state() == QProcess::Running)
 				{
-					if(++waitCounter > m_processTimeoutMaxCounter)
-					{
-						if(m_preferences->getAbortOnTimeout())
-						{
-							processEncode.kill();
-							qWarning("encoder process timed out <-- killing!");
-							log("\nPROCESS TIMEOUT !!!");
-							bTimeout = true;
-							break;
-						}
-					}
-					else if(waitCounter == m_processTimeoutWarning)
+					if(runEncodingPass_checkWatchdog(watchdog, last_progress))
 					{
-						unsigned int timeOut = (waitCounter * m_processTimeoutInterval) / 1000U;
-						log(tr("Warning: encoder did not respond for %1 seconds, potential deadlock...").arg(QString::number(timeOut)));
+						processEncode.kill();
+						bTimeout = true;
+						break;
 					}
 					continue;
 				}
@@ -164,12 +228,20 @@ bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString
 		}
 
 		//Process all output
-		PROCESS_PENDING_LINES(processEncode, runEncodingPass_parseLine, patterns, clipInfo, pass, last_progress, size_estimate);
+		PROCESS_PENDING_LINES(processEncode, runEncodingPass_handleLine, watchdog, patterns, clipInfo, pass, last_progress, size_estimate);
+
+		//Encoder may still be printing without making any progress
+		if(runEncodingPass_checkWatchdog(watchdog, last_progress))
+		{
+			processEncode.kill();
+			bTimeout = true;
+			break;
+		}
 	}
 	
 	if(!(bTimeout || bAborted))
 	{
-		PROCESS_PENDING_LINES(processEncode, runEncodingPass_parseLine, patterns, clipInfo, pass, last_progress, size_estimate);
+		PROCESS_PENDING_LINES(processEncode, runEncodingPass_handleLine, watchdog, patterns, clipInfo, pass, last_progress, size_estimate);
 	}
 
 	processEncode.waitForFinished(5000);
@@ -180,7 +252,19 @@ bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString
 		processEncode.waitForFinished(-1);
 	}
 	
-	if(pipedSource)
+	if(inputSpool)
+	{
+		const QStringList messages = inputSpool->getMessages().split('\n', QString::SkipEmptyParts);
+		for(QStringList::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); iter++)
+		{
+			log(tr("render [info]: %1").arg(iter->simplified()));
+		}
+		if(inputSpool->getExitCode() != EXIT_SUCCESS)
+		{
+			log(tr("\nWARNING: Render-ahead process exited with error (code: %1), your encode might be *incomplete* !!!").arg(QString::number(inputSpool->getExitCode())));
+		}
+	}
+	else if(pipedSource)
 	{
 		processInput.waitForFinished(5000);
 		if(processInput.state() != QProcess::NotRunning)
@@ -246,6 +330,62 @@ bool AbstractEncoder::runEncodingPass(AbstractSource* pipedSource, const QString
 	return true;
 }
 
+void AbstractEncoder::runEncodingPass_handleLine(const QString &line, JobWatchdog &watchdog, const QList<QRegExp*> &patterns, const ClipInfo &clipInfo, const int &pass, double &last_progress, double &size_estimate)
+{
+	watchdog.addLine(line);
+	runEncodingPass_parseLine(line, patterns, clipInfo, pass, last_progress, size_estimate);
+}
+
+bool AbstractEncoder::runEncodingPass_checkWatchdog(JobWatchdog &watchdog, const double &progress)
+{
+	switch(watchdog.check(progress))
+	{
+	case JobWatchdog::WATCHDOG_WARNING:
+		log(tr("Warning: encoder did not make any progress for %1 seconds, potential deadlock...").arg(QString::number(watchdog.getStalledTime())));
+		break;
+	case JobWatchdog::WATCHDOG_STALLED:
+		if(m_preferences->getAbortOnTimeout())
+		{
+			qWarning("encoder process stalled <-- killing!");
+			log(tr("\n--- WATCHDOG ---\n"));
+			const QStringList diagnostics = watchdog.getDiagnostics();
+			for(QStringList::ConstIterator iter = diagnostics.constBegin(); iter != diagnostics.constEnd(); iter++)
+			{
+				log(*iter);
+			}
+			log("\nPROCESS TIMEOUT !!!");
+			return true;
+		}
+		break;
+	}
+
+	return false;
+}
+
+void AbstractEncoder::runEncodingPass_feedInput(QProcess &processEncode, RenderSpool *const renderSpool, bool &endOfInput)
+{
+	if(endOfInput || (processEncode.state() != QProcess::Running))
+	{
+		return;
+	}
+
+	//Keep the write buffer filled, Qt writes it to the encoder while waiting for output
+	if(processEncode.bytesToWrite() < m_feedChunkSize)
+	{
+		QByteArray buffer;
+		const qint64 length = renderSpool->read(buffer, m_feedChunkSize, 0);
+		if(length > 0)
+		{
+			processEncode.write(buffer);
+		}
+		else if(length < 0)
+		{
+			processEncode.closeWriteChannel();
+			endOfInput = true;
+		}
+	}
+}
+
 // ------------------------------------------------------------
 // Utilities
 // ------------------------------------------------------------
@@ -265,6 +405,16 @@ double AbstractEncoder::estimateSize(const QString &fileName, const double &prog
 	return estimatedSize;
 }
 
+QString AbstractEncoder::makeIndexFile(const QString &sourceFile)
+{
+	const QString indexFile = IndexCache::getIndexFile(sourceFile);
+	if(indexFile.isEmpty())
+	{
+		return QString("%1/~%2.ffindex").arg(QDir::tempPath(), stringToHash(sourceFile)); /*fall back to temp directory*/
+	}
+	return indexFile;
+}
+
 QString AbstractEncoder::sizeToString(qint64 size)
 {
 	static char *prefix[5] = {"Byte", "KB", "MB", "GB", "TB"};
@@ -28,7 +28,9 @@ class QRegExp;
 template<class T> class QList;
 template <class T1, class T2> struct QPair;
 class AbstractSource;
+class JobWatchdog;
 class ClipInfo;
+class RenderSpool;
 
 class AbstractEncoderInfo
 {
@@ -79,9 +81,20 @@ public:
 	AbstractEncoder(JobObject *jobObject, const OptionsModel *options, const SysinfoModel *const sysinfo, const PreferencesModel *const preferences, JobStatus &jobStatus, volatile bool *abort, volatile bool *pause, QSemaphore *semaphorePause, const QString &sourceFile, const QString &outputFile);
 	virtual ~AbstractEncoder(void);
 
-	virtual bool runEncodingPass(AbstractSource* pipedSource, const QString outputFile, const ClipInfo &clipInfo, const int &pass = 0, const QString &passLogFile = QString());
+	virtual bool runEncodingPass(AbstractSource* pipedSource, const QString outputFile, const ClipInfo &clipInfo, const int &pass = 0, const QString &passLogFile = QString(), RenderSpool *const renderSpool = NULL);
 	
 	virtual const AbstractEncoderInfo& getEncoderInfo(void) const = 0;
+	virtual void checkCustomParams(void);
+
+	//Native input indexing
+	virtual bool getIndexCommand(QString &program, QStringList &cmdLine, const QString &indexFile) const { return false; }
+	const QString &getIndexFile(void) const { return m_indexFile; }
+
+	//Input/Output staging
+	void setInputFile(const QString &inputFile) { m_inputFile = inputFile; }
+	void setOutputFile(const QString &outputFile) { m_outputFile = outputFile; }
+
+	static QString sizeToString(qint64 size);
 
 protected:
 	virtual void buildCommandLine(QStringList &cmdLine, const bool &usePipe, const ClipInfo &clipInfo, const QString &indexFile, const int &pass, const QString &passLogFile) = 0;
@@ -89,10 +102,18 @@ protected:
 	virtual void runEncodingPass_init(QList<QRegExp*> &patterns) = 0;
 	virtual void runEncodingPass_parseLine(const QString &line, const QList<QRegExp*> &patterns, const ClipInfo &clipInfo, const int &pass, double &last_progress, double &size_estimate) = 0;
 
+	void runEncodingPass_handleLine(const QString &line, JobWatchdog &watchdog, const QList<QRegExp*> &patterns, const ClipInfo &clipInfo, const int &pass, double &last_progress, double &size_estimate);
+	bool runEncodingPass_checkWatchdog(JobWatchdog &watchdog, const double &progress);
+	void runEncodingPass_feedInput(QProcess &processEncode, RenderSpool *const renderSpool, bool &endOfInput);
+
+	static const unsigned int m_feedInterval = 25;
+	static const qint64 m_feedChunkSize = 8388608;
+
 	static double estimateSize(const QString &fileName, const double &progress);
-	static QString sizeToString(qint64 size);
+	static QString makeIndexFile(const QString &sourceFile);
 
 	const QString &m_sourceFile;
-	const QString &m_outputFile;
+	QString m_outputFile;
 	const QString m_indexFile;
+	QString m_inputFile;
 };
@@ -418,7 +418,7 @@ void NVEncEncoder::buildCommandLine(QStringList &cmdLine, const bool &usePipe, c
 	}
 	else
 	{
-		cmdLine << "--input" << QDir::toNativeSeparators(m_sourceFile);
+		cmdLine << "--input" << QDir::toNativeSeparators(m_inputFile);
 	}
 }
 
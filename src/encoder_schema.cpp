@@ -0,0 +1,439 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "encoder_schema.h"
+
+//Internal
+#include "global.h"
+#include "cache_file.h"
+#include "tool_abstract.h"
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/OSSupport.h>
+
+//Qt
+#include <QProcess>
+#include <QDir>
+#include <QRegExp>
+#include <QMutexLocker>
+
+//Static
+QMutex EncoderSchema::s_mutex;
+QHash<QString, QSharedPointer<const EncoderSchema> > EncoderSchema::s_schemas;
+static FileCache g_schemaCache("schemas");
+
+//Helper functions
+static inline bool IS_NUMBER(const QString &str)
+{
+	return QRegExp("^[-+]?\\d*\\.?\\d+$").exactMatch(str);
+}
+
+// ------------------------------------------------------------
+// Schema Access
+// ------------------------------------------------------------
+
+QSharedPointer<const EncoderSchema> EncoderSchema::lookup(const QString &binaryPath)
+{
+	const QString key = QDir::fromNativeSeparators(binaryPath).toLower();
+	QMutexLocker lock(&s_mutex);
+
+	if(s_schemas.contains(key))
+	{
+		return s_schemas.value(key);
+	}
+
+	QVariant value;
+	if(g_schemaCache.lookup(QStringList() << binaryPath, value))
+	{
+		if(EncoderSchema *const schema = deserialize(value.toStringList()))
+		{
+			const QSharedPointer<const EncoderSchema> result(schema);
+			s_schemas.insert(key, result);
+			return result;
+		}
+	}
+
+	return QSharedPointer<const EncoderSchema>();
+}
+
+QSharedPointer<const EncoderSchema> EncoderSchema::build(const QString &binaryPath, const QString &helpCommand)
+{
+	QSharedPointer<const EncoderSchema> result = lookup(binaryPath);
+	if(!result.isNull())
+	{
+		return result;
+	}
+
+	EncoderSchema *const schema = new EncoderSchema();
+	schema->parseHelp(runHelp(binaryPath, helpCommand));
+	if(schema->count() < MIN_OPTIONS)
+	{
+		qWarning("Failed to build option schema for: %s", MUTILS_UTF8(binaryPath));
+		MUTILS_DELETE(schema);
+		return result;
+	}
+
+	qDebug("Encoder option schema created (%d options).", schema->count());
+	result = QSharedPointer<const EncoderSchema>(schema);
+	g_schemaCache.store(QStringList() << binaryPath, schema->serialize());
+
+	QMutexLocker lock(&s_mutex);
+	s_schemas.insert(QDir::fromNativeSeparators(binaryPath).toLower(), result);
+	return result;
+}
+
+// ------------------------------------------------------------
+// Validation
+// ------------------------------------------------------------
+
+bool EncoderSchema::validate(const QStringList &tokens, QString &error) const
+{
+	for(int i = 0; i < tokens.count(); i++)
+	{
+		const QString &token = tokens.at(i);
+		if((!token.startsWith(QLatin1Char('-'))) || IS_NUMBER(token))
+		{
+			error = QString("Unexpected value: %1").arg(token);
+			return false;
+		}
+
+		QString name, value;
+		bool hasValue = false;
+		if(token.startsWith(QLatin1String("--")))
+		{
+			const int offset = token.indexOf(QLatin1Char('='));
+			hasValue = (offset > 2);
+			name = hasValue ? token.mid(2, offset - 2) : token.mid(2);
+			value = hasValue ? token.mid(offset + 1) : QString();
+		}
+		else
+		{
+			hasValue = (token.length() > 2);
+			name = token.mid(1, 1);
+			value = token.mid(2);
+		}
+
+		if(!m_options.contains(name))
+		{
+			error = QString("Unknown parameter: %1").arg(token);
+			return false;
+		}
+
+		const Option &option = m_options[name];
+		if(option.type == VALUE_NONE)
+		{
+			if(hasValue)
+			{
+				error = QString("Parameter does not take a value: %1").arg(token);
+				return false;
+			}
+			continue;
+		}
+
+		if(!hasValue)
+		{
+			QString ignored;
+			const bool nextIsValue = (i + 1 < tokens.count()) && ((!tokens.at(i + 1).startsWith(QLatin1Char('-'))) || IS_NUMBER(tokens.at(i + 1)));
+			if(nextIsValue && ((!option.optional) || checkValue(token, option, tokens.at(i + 1), ignored)))
+			{
+				value = tokens.at(++i);
+			}
+			else if(option.optional)
+			{
+				continue; /*value may be omitted, e.g. "--param [<value>]"*/
+			}
+			else
+			{
+				error = QString("Missing value for parameter: %1").arg(token);
+				return false;
+			}
+		}
+
+		if(!checkValue(token, option, value, error))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool EncoderSchema::checkValue(const QString &name, const Option &option, const QString &value, QString &error) const
+{
+	if(value.compare(QLatin1String("auto"), Qt::CaseInsensitive) == 0)
+	{
+		return true;
+	}
+
+	switch(option.type)
+	{
+	case VALUE_INTEGER:
+		if(!QRegExp("^[-+]?\\d+$").exactMatch(value))
+		{
+			error = QString("Integer value expected: %1 %2").arg(name, value);
+			return false;
+		}
+		break;
+	case VALUE_FLOAT:
+		if(!IS_NUMBER(value))
+		{
+			error = QString("Numeric value expected: %1 %2").arg(name, value);
+			return false;
+		}
+		break;
+	case VALUE_STRING:
+		if(!option.allowedValues.isEmpty())
+		{
+			const QStringList parts = value.split(QLatin1Char(','), QString::SkipEmptyParts);
+			for(QStringList::ConstIterator iter = parts.constBegin(); iter != parts.constEnd(); iter++)
+			{
+				if(!option.allowedValues.contains(*iter, Qt::CaseInsensitive))
+				{
+					error = QString("Unsupported value: %1 %2").arg(name, *iter);
+					return false;
+				}
+			}
+		}
+		break;
+	default:
+		break;
+	}
+
+	return true;
+}
+
+// ------------------------------------------------------------
+// Help Text Parser
+// ------------------------------------------------------------
+
+void EncoderSchema::parseHelp(const QStringList &lines)
+{
+	QRegExp rxName("^(-{1,2})(\\[no-\\])?([A-Za-z][A-Za-z0-9\\-]*)");
+	QRegExp rxNext("^\\s*[,/]\\s*(?=-)");
+	QRegExp rxValue("^\\s(\\[)?<([^>]+)>\\]?(\\S*)(\\s+or\\s+)?");
+	QRegExp rxPlainValue("^\\s(\\S+)(\\s{2,}|$)");
+	QRegExp rxAllowed("^\\s+-\\s+(\\S.*)$");
+	QRegExp rxLabel("^[A-Za-z][A-Za-z ]*:\\s*");
+	QRegExp rxContinued("^\\s+[A-Za-z0-9_\\.\\-]+(\\s*,\\s*[A-Za-z0-9_\\.\\-]+)*,?\\s*$");
+	QRegExp rxToken("^[A-Za-z0-9_\\.\\-]+$");
+
+	QStringList pendingNames, allowedValues;
+	bool allowedValid = false, allowedOpen = false;
+
+	for(int i = 0; i <= lines.count(); i++)
+	{
+		const QString line = (i < lines.count()) ? lines.at(i) : QString();
+
+		//Collect the allowed values of the preceding string option, e.g. "- psy tunings: film,animation,grain,"
+		//Lists that end with a comma are continued on the next line, e.g. "stillimage,psnr,ssim"
+		if(!pendingNames.isEmpty())
+		{
+			QString text;
+			if(rxAllowed.indexIn(line) >= 0)
+			{
+				text = rxAllowed.cap(1).trimmed().remove(rxLabel);
+			}
+			else if(allowedOpen && rxContinued.exactMatch(line))
+			{
+				text = line.trimmed();
+			}
+			if(!text.isEmpty())
+			{
+				const QStringList values = text.split(QRegExp("[,\\s]+"), QString::SkipEmptyParts);
+				for(QStringList::ConstIterator iter = values.constBegin(); iter != values.constEnd(); iter++)
+				{
+					allowedValid = allowedValid && rxToken.exactMatch(*iter);
+				}
+				allowedValues << values;
+				allowedOpen = text.endsWith(QLatin1Char(','));
+				continue;
+			}
+			allowedOpen = false;
+		}
+
+		//Parse the option name(s)
+		QString text = line.trimmed();
+		QStringList names;
+		bool negatable = false;
+		while(rxName.indexIn(text) >= 0)
+		{
+			const bool isShort = (rxName.cap(1).length() == 1);
+			if(isShort && ((rxName.cap(3).length() != 1) || (!rxName.cap(2).isEmpty())))
+			{
+				break; /*not a valid short option*/
+			}
+			negatable = negatable || (!rxName.cap(2).isEmpty());
+			names << rxName.cap(3);
+			text = text.mid(rxName.matchedLength());
+			if(rxNext.indexIn(text) < 0)
+			{
+				break;
+			}
+			text = text.mid(rxNext.matchedLength());
+		}
+
+		if(names.isEmpty() && (i < lines.count()))
+		{
+			continue;
+		}
+
+		//Assign allowed values of the preceding option
+		if(allowedValid && (!allowedValues.isEmpty()))
+		{
+			for(QStringList::ConstIterator iter = pendingNames.constBegin(); iter != pendingNames.constEnd(); iter++)
+			{
+				m_options[*iter].allowedValues = allowedValues;
+			}
+		}
+		pendingNames.clear();
+		allowedValues.clear();
+		if(names.isEmpty())
+		{
+			break; /*end of help text*/
+		}
+
+		//Determine the type of the value
+		Option option;
+		option.type = VALUE_NONE;
+		option.optional = false;
+		if(rxValue.indexIn(text) >= 0)
+		{
+			option.optional = (!rxValue.cap(1).isEmpty());
+			const QString typeName = rxValue.cap(2).trimmed().toLower();
+			const bool simple = rxValue.cap(3).isEmpty() && rxValue.cap(4).isEmpty();
+			if(simple && ((typeName == QLatin1String("integer")) || (typeName == QLatin1String("int"))))
+			{
+				option.type = VALUE_INTEGER;
+			}
+			else if(simple && (typeName == QLatin1String("float")))
+			{
+				option.type = VALUE_FLOAT;
+			}
+			else
+			{
+				option.type = VALUE_STRING;
+			}
+		}
+		else if(rxPlainValue.indexIn(text) >= 0)
+		{
+			option.type = VALUE_STRING; /*e.g. "--sar width:height"*/
+		}
+
+		for(QStringList::ConstIterator iter = names.constBegin(); iter != names.constEnd(); iter++)
+		{
+			m_options.insert(*iter, option);
+			if(negatable)
+			{
+				Option negated;
+				negated.type = VALUE_NONE;
+				negated.optional = false;
+				m_options.insert(QString("no-%1").arg(*iter), negated);
+			}
+		}
+
+		if(option.type == VALUE_STRING)
+		{
+			pendingNames = names;
+			allowedValid = true;
+		}
+	}
+}
+
+// ------------------------------------------------------------
+// Serialization
+// ------------------------------------------------------------
+
+QStringList EncoderSchema::serialize(void) const
+{
+	QStringList data;
+	for(QHash<QString, Option>::ConstIterator iter = m_options.constBegin(); iter != m_options.constEnd(); iter++)
+	{
+		data << QString("%1\t%2\t%3\t%4").arg(iter.key(), QString::number(iter->type), iter->allowedValues.join(","), QString::number(iter->optional ? 1 : 0));
+	}
+	return data;
+}
+
+EncoderSchema *EncoderSchema::deserialize(const QStringList &data)
+{
+	EncoderSchema *const schema = new EncoderSchema();
+	for(QStringList::ConstIterator iter = data.constBegin(); iter != data.constEnd(); iter++)
+	{
+		const QStringList fields = iter->split(QLatin1Char('\t'));
+		bool ok = false;
+		const int type = (fields.count() == 4) ? fields[1].toInt(&ok) : -1;
+		if((!ok) || (type < VALUE_NONE) || (type > VALUE_STRING) || fields[0].isEmpty())
+		{
+			MUTILS_DELETE(schema);
+			return NULL;
+		}
+		Option option;
+		option.type = static_cast<ValueType>(type);
+		option.optional = (fields[3].toInt() != 0);
+		option.allowedValues = fields[2].split(QLatin1Char(','), QString::SkipEmptyParts);
+		schema->m_options.insert(fields[0], option);
+	}
+
+	if(schema->count() < MIN_OPTIONS)
+	{
+		MUTILS_DELETE(schema);
+		return NULL;
+	}
+
+	return schema;
+}
+
+// ------------------------------------------------------------
+// Process
+// ------------------------------------------------------------
+
+QStringList EncoderSchema::runHelp(const QString &binaryPath, const QString &helpCommand)
+{
+	QProcess process;
+	MUtils::init_process(process, QDir::tempPath(), true);
+
+	if(!AbstractTool::launchProcess(process, binaryPath, QStringList() << helpCommand, NULL))
+	{
+		qWarning("Failed to launch encoder for help screen: %s", MUTILS_UTF8(process.errorString()));
+		return QStringList();
+	}
+
+	if(!process.waitForFinished(15000))
+	{
+		qWarning("Encoder process did not exit -> killing!");
+		process.kill();
+		process.waitForFinished(-1);
+	}
+
+	QStringList lines;
+	const QList<QByteArray> data = process.readAll().split('\n');
+	for(QList<QByteArray>::ConstIterator iter = data.constBegin(); iter != data.constEnd(); iter++)
+	{
+		QString line = QString::fromLatin1(iter->constData(), iter->size());
+		while(line.endsWith(QLatin1Char('\r')))
+		{
+			line.chop(1);
+		}
+		lines << line;
+	}
+	return lines;
+}
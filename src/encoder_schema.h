@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+
+class EncoderSchema
+{
+public:
+	typedef enum
+	{
+		VALUE_NONE    = 0,
+		VALUE_INTEGER = 1,
+		VALUE_FLOAT   = 2,
+		VALUE_STRING  = 3
+	}
+	ValueType;
+
+	typedef struct
+	{
+		ValueType type;
+		bool optional;
+		QStringList allowedValues;
+	}
+	Option;
+
+	static QSharedPointer<const EncoderSchema> lookup(const QString &binaryPath);
+	static QSharedPointer<const EncoderSchema> build(const QString &binaryPath, const QString &helpCommand);
+
+	bool validate(const QStringList &tokens, QString &error) const;
+	int count(void) const { return m_options.count(); }
+
+protected:
+	static const int MIN_OPTIONS = 16;
+
+	EncoderSchema(void) {}
+
+	void parseHelp(const QStringList &lines);
+	bool checkValue(const QString &name, const Option &option, const QString &value, QString &error) const;
+
+	QStringList serialize(void) const;
+	static EncoderSchema *deserialize(const QStringList &data);
+	static QStringList runHelp(const QString &binaryPath, const QString &helpCommand);
+
+	QHash<QString, Option> m_options;
+
+	static QMutex s_mutex;
+	static QHash<QString, QSharedPointer<const EncoderSchema> > s_schemas;
+};
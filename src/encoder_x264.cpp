@@ -397,10 +397,21 @@ void X264Encoder::buildCommandLine(QStringList &cmdLine, const bool &usePipe, co
 	else
 	{
 		cmdLine << "--index" << QDir::toNativeSeparators(indexFile);
-		cmdLine << QDir::toNativeSeparators(m_sourceFile);
+		cmdLine << QDir::toNativeSeparators(m_inputFile);
 	}
 }
 
+bool X264Encoder::getIndexCommand(QString &program, QStringList &cmdLine, const QString &indexFile) const
+{
+	//Encoding a single frame is enough, because the complete file is indexed first
+	program = getBinaryPath();
+	cmdLine << "--preset" << "ultrafast" << "--frames" << "1";
+	cmdLine << "--index" << QDir::toNativeSeparators(indexFile);
+	cmdLine << "--output" << "NUL";
+	cmdLine << QDir::toNativeSeparators(m_sourceFile);
+	return true;
+}
+
 void X264Encoder::runEncodingPass_init(QList<QRegExp*> &patterns)
 {
 	patterns << new QRegExp("\\[(\\d+)\\.(\\d+)%\\].+frames");
@@ -37,6 +37,8 @@ public:
 	virtual const AbstractEncoderInfo& getEncoderInfo(void) const;
 	static const AbstractEncoderInfo& encoderInfo(void);
 
+	virtual bool getIndexCommand(QString &program, QStringList &cmdLine, const QString &indexFile) const;
+
 protected:
 	virtual QString getBinaryPath() const { return getEncoderInfo().getBinaryPath(m_sysinfo, m_options->encArch(), m_options->encVariant()); }
 	virtual void buildCommandLine(QStringList &cmdLine, const bool &usePipe, const ClipInfo &clipInfo, const QString &indexFile, const int &pass, const QString &passLogFile);
@@ -397,7 +397,7 @@ void X265Encoder::buildCommandLine(QStringList &cmdLine, const bool &usePipe, co
 	}
 	else
 	{
-		cmdLine << QDir::toNativeSeparators(m_sourceFile);
+		cmdLine << QDir::toNativeSeparators(m_inputFile);
 	}
 }
 
@@ -54,6 +54,7 @@
 #include <QApplication>
 #include <QMessageBox>
 #include <QDir>
+#include <QFileInfo>
 #include <QUuid>
 #include <QMap>
 #include <QDate>
@@ -293,6 +294,60 @@ QString x264_path2ansi(const QString &longPath, bool makeLowercase)
 	return shortPath;
 }
 
+/*
+ * Get file identity (volume serial, file index, size and modification time)
+ */
+QString x264_file_identity(const QString &filePath)
+{
+	const QString filePathNative = QDir::toNativeSeparators(filePath);
+	const HANDLE hFile = CreateFileW(MUTILS_WCHR(filePathNative), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		return QString();
+	}
+
+	QString identity;
+	BY_HANDLE_FILE_INFORMATION info;
+	if(GetFileInformationByHandle(hFile, &info))
+	{
+		const quint64 fileIndex = (quint64(info.nFileIndexHigh) << 32) | quint64(info.nFileIndexLow);
+		const quint64 fileSize  = (quint64(info.nFileSizeHigh)  << 32) | quint64(info.nFileSizeLow);
+		const quint64 writeTime = (quint64(info.ftLastWriteTime.dwHighDateTime) << 32) | quint64(info.ftLastWriteTime.dwLowDateTime);
+		identity = QString("%1:%2:%3:%4").arg(QString::number(info.dwVolumeSerialNumber, 16), QString::number(fileIndex, 16), QString::number(fileSize, 16), QString::number(writeTime, 16));
+	}
+
+	CloseHandle(hFile);
+	return identity;
+}
+
+/*
+ * Atomically replace the target file with the source file (on the same volume)
+ */
+bool x264_replace_file(const QString &sourcePath, const QString &targetPath)
+{
+	const QString sourcePathNative = QDir::toNativeSeparators(sourcePath);
+	const QString targetPathNative = QDir::toNativeSeparators(targetPath);
+	return (MoveFileExW(MUTILS_WCHR(sourcePathNative), MUTILS_WCHR(targetPathNative), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE);
+}
+
+/*
+ * Check whether the file is located on a network share
+ */
+bool x264_is_remote_path(const QString &filePath)
+{
+	const QString nativePath = QDir::toNativeSeparators(QFileInfo(filePath).absoluteFilePath());
+	if(nativePath.startsWith("\\\\"))
+	{
+		return true; /*UNC path*/
+	}
+	if((nativePath.length() >= 2) && (nativePath.at(1) == QLatin1Char(':')))
+	{
+		const QString rootPath = QString("%1\\").arg(nativePath.left(2));
+		return (GetDriveTypeW(MUTILS_WCHR(rootPath)) == DRIVE_REMOTE);
+	}
+	return false;
+}
+
 /*
  * Inform the system that it is in use, thereby preventing the system from entering sleep
  */
@@ -309,3 +364,13 @@ bool x264_set_thread_execution_state(const bool systemRequired)
 	}
 	return (state != NULL);
 }
+
+/*
+ * Hash function for QUuid, so that job ids can be used as QHash keys
+ */
+unsigned int qHash(const QUuid &key)
+{
+	return key.data1 ^ (uint(key.data2) << 16 | uint(key.data3)) ^
+		(uint(key.data4[0]) << 24 | uint(key.data4[1]) << 16 | uint(key.data4[2]) << 8 | uint(key.data4[3])) ^
+		(uint(key.data4[4]) << 24 | uint(key.data4[5]) << 16 | uint(key.data4[6]) << 8 | uint(key.data4[7]));
+}
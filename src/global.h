@@ -34,6 +34,7 @@ class QIcon;
 class QWidget;
 class LockedFile;
 class QProcess;
+class QUuid;
 
 ///////////////////////////////////////////////////////////////////////////////
 // GLOBAL FUNCTIONS
@@ -42,8 +43,14 @@ class QProcess;
 //Utility functions
 const QString &x264_data_path(void);
 QString x264_path2ansi(const QString &longPath, bool makeLowercase = false);
+QString x264_file_identity(const QString &filePath);
+bool x264_replace_file(const QString &sourcePath, const QString &targetPath);
+bool x264_is_remote_path(const QString &filePath);
 bool x264_set_thread_execution_state(const bool systemRequired);
 
+//Qt4 does not provide a hash function for QUuid
+unsigned int qHash(const QUuid &key);
+
 //Version getters
 unsigned int x264_version_major(void);
 unsigned int x264_version_minor(void);
@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "job_descriptor.h"
+
+//Internal
+#include "global.h"
+#include "model_options.h"
+#include "model_sysinfo.h"
+#include "model_preferences.h"
+#include "model_status.h"
+#include "mediainfo.h"
+#include "cache_index.h"
+#include "job_render.h"
+#include "job_stage.h"
+#include "encoder_abstract.h"
+#include "encoder_factory.h"
+#include "source_abstract.h"
+#include "source_factory.h"
+
+//Qt
+#include <QDir>
+#include <QFileInfo>
+#include <QSemaphore>
+#include <QHash>
+#include <QScopedPointer>
+
+///////////////////////////////////////////////////////////////////////////////
+// Helper
+///////////////////////////////////////////////////////////////////////////////
+
+//Encoder and source objects are only needed to build command-lines here, they never start a process
+class ToolContext
+{
+public:
+	ToolContext(void) : m_status(JobStatus_Enqueued), m_abort(false), m_pause(false), m_semaphorePaused(0) {}
+
+	AbstractEncoder *createEncoder(const JobDescriptor &job, const SysinfoModel *const sysinfo, const PreferencesModel *const preferences)
+	{
+		return EncoderFactory::createEncoder(NULL, job.options(), sysinfo, preferences, m_status, &m_abort, &m_pause, &m_semaphorePaused, job.sourceFileName(), job.outputFileName());
+	}
+
+	AbstractSource *createSource(const SourceFactory::SourceType &type, const JobDescriptor &job, const SysinfoModel *const sysinfo, const PreferencesModel *const preferences)
+	{
+		return SourceFactory::createSource(type, NULL, job.options(), sysinfo, preferences, m_status, &m_abort, &m_pause, &m_semaphorePaused, job.sourceFileName());
+	}
+
+private:
+	JobStatus m_status;
+	volatile bool m_abort;
+	volatile bool m_pause;
+	QSemaphore m_semaphorePaused;
+};
+
+static bool getSourceType(const int &fileType, const SysinfoModel *const sysinfo, SourceFactory::SourceType &type)
+{
+	switch(fileType)
+	{
+	case MediaInfo::FILETYPE_AVISYNTH:
+		type = SourceFactory::SourceType_AVS;
+		return sysinfo->hasAvisynth();
+	case MediaInfo::FILETYPE_VAPOURSYNTH:
+		type = SourceFactory::SourceType_VPS;
+		return sysinfo->hasVapourSynth();
+	}
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+JobDescriptor::JobDescriptor(void)
+:
+	m_interactive(false),
+	m_ioPriority(IO_PRIORITY_DEFAULT),
+	m_ioBandwidthLimit(IO_BANDWIDTH_DEFAULT),
+	m_fileType(-1),
+	m_remoteSource(-1)
+{
+}
+
+JobDescriptor::JobDescriptor(const QString &sourceFileName, const QString &outputFileName, const OptionsModel *options, const QUuid &jobId)
+:
+	m_jobId(jobId.isNull() ? QUuid::createUuid() : jobId),
+	m_sourceFileName(sourceFileName),
+	m_outputFileName(outputFileName),
+	m_options(new OptionsModel(*options)),
+	m_interactive(false),
+	m_ioPriority(IO_PRIORITY_DEFAULT),
+	m_ioBandwidthLimit(IO_BANDWIDTH_DEFAULT),
+	m_fileType(-1),
+	m_remoteSource(-1)
+{
+}
+
+JobDescriptor::~JobDescriptor(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Look-ahead
+///////////////////////////////////////////////////////////////////////////////
+
+bool JobDescriptor::getIndexCommand(const SysinfoModel *const sysinfo, const PreferencesModel *const preferences, QString &program, QStringList &args, QString &indexFile) const
+{
+	SourceFactory::SourceType sourceType;
+	if((!m_options) || getSourceType(getFileType(), sysinfo, sourceType))
+	{
+		return false; /*no native input*/
+	}
+
+	ToolContext context;
+	QScopedPointer<AbstractEncoder> encoder(context.createEncoder(*this, sysinfo, preferences));
+	if(encoder.isNull())
+	{
+		return false;
+	}
+
+	indexFile = encoder->getIndexFile();
+	if(QFileInfo(indexFile).exists())
+	{
+		return false; /*already indexed*/
+	}
+
+	return encoder->getIndexCommand(program, args, IndexCache::getTempFile(indexFile));
+}
+
+QSharedPointer<RenderSpool> JobDescriptor::createRenderSpool(const SysinfoModel *const sysinfo, const PreferencesModel *const preferences, const qint64 &capacity)
+{
+	SourceFactory::SourceType sourceType;
+	if((!m_options) || (!m_renderSpool.isNull()) || (!getSourceType(getFileType(), sysinfo, sourceType)))
+	{
+		return QSharedPointer<RenderSpool>();
+	}
+
+	ToolContext context;
+	QScopedPointer<AbstractSource> source(context.createSource(sourceType, *this, sysinfo, preferences));
+	if(source.isNull())
+	{
+		return QSharedPointer<RenderSpool>();
+	}
+
+	QString program;
+	QStringList args, extraPaths;
+	QHash<QString, QString> extraEnv;
+	source->getRenderCommand(program, args, extraPaths, extraEnv);
+
+	const QString fileName = QString("%1/~%2.y4m").arg(QDir::tempPath(), m_jobId.toString().mid(1, 36));
+	m_renderSpool = QSharedPointer<RenderSpool>(new RenderSpool(fileName, capacity));
+	m_renderSpool->setCommand(program, args, extraPaths, extraEnv, preferences->getProcessPriority());
+
+	return m_renderSpool;
+}
+
+QSharedPointer<InputStage> JobDescriptor::createInputStage(const SysinfoModel *const sysinfo, const qint64 &maxSize)
+{
+	SourceFactory::SourceType sourceType;
+	if((!m_inputStage.isNull()) || (!isRemoteSource()) || getSourceType(getFileType(), sysinfo, sourceType))
+	{
+		return QSharedPointer<InputStage>(); /*only native input from network shares*/
+	}
+
+	const QFileInfo sourceInfo(m_sourceFileName);
+	if(!(sourceInfo.exists() && sourceInfo.isFile() && (sourceInfo.size() <= maxSize)))
+	{
+		return QSharedPointer<InputStage>();
+	}
+
+	//Keep the suffix, because the encoder detects the input format from it
+	const QString stagedFile = QString("%1/~%2.%3").arg(QDir::tempPath(), m_jobId.toString().mid(1, 36), sourceInfo.suffix());
+	m_inputStage = QSharedPointer<InputStage>(new InputStage(m_sourceFileName, stagedFile, sourceInfo.size()));
+
+	return m_inputStage;
+}
+
+qint64 JobDescriptor::getInputStageSize(void) const
+{
+	return m_inputStage.isNull() ? 0 : m_inputStage->getSize();
+}
+
+void JobDescriptor::releaseLookAhead(const bool &cancel)
+{
+	if(cancel)
+	{
+		if(!m_renderSpool.isNull())
+		{
+			m_renderSpool->cancel();
+		}
+		if(!m_inputStage.isNull())
+		{
+			m_inputStage->cancel();
+		}
+	}
+
+	m_renderSpool.clear();
+	m_inputStage.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal
+///////////////////////////////////////////////////////////////////////////////
+
+int JobDescriptor::getFileType(void) const
+{
+	if(m_fileType < 0)
+	{
+		m_fileType = MediaInfo::analyze(m_sourceFileName);
+	}
+	return m_fileType;
+}
+
+bool JobDescriptor::isRemoteSource(void) const
+{
+	if(m_remoteSource < 0)
+	{
+		m_remoteSource = x264_is_remote_path(m_sourceFileName) ? 1 : 0;
+	}
+	return (m_remoteSource > 0);
+}
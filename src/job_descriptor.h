@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QUuid>
+#include <QSharedPointer>
+
+class OptionsModel;
+class SysinfoModel;
+class PreferencesModel;
+class RenderSpool;
+class InputStage;
+
+class JobDescriptor
+{
+public:
+	JobDescriptor(void);
+	JobDescriptor(const QString &sourceFileName, const QString &outputFileName, const OptionsModel *options, const QUuid &jobId = QUuid());
+	~JobDescriptor(void);
+
+	const QUuid &getId(void) const { return m_jobId; }
+	bool isValid(void) const { return !m_jobId.isNull(); }
+	const QString &sourceFileName(void) const { return m_sourceFileName; }
+	const QString &outputFileName(void) const { return m_outputFileName; }
+	const OptionsModel *options(void) const { return m_options.data(); }
+
+	bool isInteractive(void) const { return m_interactive; }
+	void setInteractive(const bool &interactive) { m_interactive = interactive; }
+
+	//Per-job I/O class, the default values defer to the preferences
+	static const int IO_PRIORITY_DEFAULT = 1;
+	static const int IO_BANDWIDTH_DEFAULT = -1;
+	int getIoPriority(void) const { return m_ioPriority; }
+	int getIoBandwidthLimit(void) const { return m_ioBandwidthLimit; }
+	void setIoClass(const int &ioPriority, const int &ioBandwidthLimit) { m_ioPriority = ioPriority; m_ioBandwidthLimit = ioBandwidthLimit; }
+
+	void setOutputFileName(const QString &outputFileName) { m_outputFileName = outputFileName; }
+	void dropOptions(void) { m_options.clear(); }
+
+	//Work that is done ahead of time, while the job is still enqueued
+	bool getIndexCommand(const SysinfoModel *const sysinfo, const PreferencesModel *const preferences, QString &program, QStringList &args, QString &indexFile) const;
+	QSharedPointer<RenderSpool> createRenderSpool(const SysinfoModel *const sysinfo, const PreferencesModel *const preferences, const qint64 &capacity);
+	const QSharedPointer<RenderSpool> &getRenderSpool(void) const { return m_renderSpool; }
+	QSharedPointer<InputStage> createInputStage(const SysinfoModel *const sysinfo, const qint64 &maxSize);
+	const QSharedPointer<InputStage> &getInputStage(void) const { return m_inputStage; }
+	qint64 getInputStageSize(void) const;
+	void releaseLookAhead(const bool &cancel);
+
+protected:
+	QUuid m_jobId;
+	QString m_sourceFileName;
+	QString m_outputFileName;
+	QSharedPointer<const OptionsModel> m_options;
+	bool m_interactive;
+	int m_ioPriority;
+	int m_ioBandwidthLimit;
+
+	QSharedPointer<RenderSpool> m_renderSpool;
+	QSharedPointer<InputStage> m_inputStage;
+
+	//The look-ahead is updated for all enqueued jobs, so the source properties are only detected once
+	mutable int m_fileType;
+	mutable int m_remoteSource;
+
+	int getFileType(void) const;
+	bool isRemoteSource(void) const;
+};
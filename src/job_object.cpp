@@ -23,6 +23,7 @@
 #include "job_object.h"
 
 #include "global.h"
+#include "model_status.h"
 
 #include <QProcess>
 
@@ -33,10 +34,56 @@
 #include <MMSystem.h>
 #include <ShellAPI.h>
 #include <WinInet.h>
+#include <Psapi.h>
+#include <TlHelp32.h>
+
+//Constants
+static const DWORD SAMPLE_INTERVAL = 1000;
+static const DWORD MAX_PROCESS_IDS = 64;
+static const int MAX_SUSPEND_PASSES = 8;
+
+//I/O priority (not declared in the SDK headers)
+static const ULONG PROCESS_INFO_IO_PRIORITY = 33;
+typedef LONG (__stdcall *NtSetInformationProcessFun)(HANDLE, ULONG, PVOID, ULONG);
+
+//Suspend and resume (not declared in the SDK headers)
+typedef LONG (__stdcall *NtSuspendResumeProcessFun)(HANDLE);
+
+//Job freeze (not declared in the SDK headers, requires Windows 8 or later)
+static const ULONG JOB_OBJECT_FREEZE_INFORMATION = 18;
+typedef struct
+{
+	ULONG Flags; /*bit #0 = FreezeOperation*/
+	BOOLEAN Freeze;
+	BOOLEAN Swap;
+	UCHAR Reserved0[2];
+	ULONG WakeFilter[2];
+}
+JOBOBJECT_FREEZE_INFO;
+typedef LONG (__stdcall *NtSetInformationJobObjectFun)(HANDLE, ULONG, PVOID, ULONG);
+
+//I/O rate control (requires Windows 10 or later)
+typedef struct
+{
+	LONG64 MaxIops;
+	LONG64 MaxBandwidth;
+	LONG64 ReservationIops;
+	PCWSTR VolumeName;
+	ULONG BaseIoSize;
+	ULONG ControlFlags;
+}
+IO_RATE_CONTROL_INFO;
+static const ULONG IO_RATE_CONTROL_ENABLE = 0x1;
+typedef DWORD (__stdcall *SetIoRateControlInformationJobObjectFun)(HANDLE, IO_RATE_CONTROL_INFO*);
 
 JobObject::JobObject(void)
 :
-	m_hJobObject(NULL)
+	m_hJobObject(NULL),
+	m_ioPriority(0),
+	m_lastProcessId(0),
+	m_frozen(false),
+	m_peakWorkingSet(0),
+	m_lastSampleTime(0)
 {
 	HANDLE jobObject = CreateJobObject(NULL, NULL);
 	if((jobObject != NULL) && (jobObject != INVALID_HANDLE_VALUE))
@@ -99,6 +146,13 @@ bool JobObject::addProcessToJob(const QProcess *proc)
 			return false;
 		}
 
+		QMutexLocker lock(&m_mutex);
+		m_lastProcessId = pid->dwProcessId;
+		if(m_ioPriority != 0)
+		{
+			applyIoPriority(pid->hProcess, m_ioPriority);
+		}
+
 		return true;
 	}
 	else
@@ -128,3 +182,416 @@ bool JobObject::terminateJob(unsigned int exitCode)
 		return false;
 	}
 }
+
+bool JobObject::setKillOnClose(const bool &enabled)
+{
+	if(!m_hJobObject)
+	{
+		qWarning("Cannot change job limits: No job object available!");
+		return false;
+	}
+
+	JOBOBJECT_EXTENDED_LIMIT_INFORMATION jobExtendedLimitInfo;
+	memset(&jobExtendedLimitInfo, 0, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION));
+	jobExtendedLimitInfo.BasicLimitInformation.LimitFlags = (enabled ? JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE : 0) | JOB_OBJECT_LIMIT_DIE_ON_UNHANDLED_EXCEPTION;
+	if(!SetInformationJobObject(m_hJobObject, JobObjectExtendedLimitInformation, &jobExtendedLimitInfo, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION)))
+	{
+		qWarning("Failed to set job object information!");
+		return false;
+	}
+
+	return true;
+}
+
+quint32 JobObject::getLastProcessId(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_lastProcessId;
+}
+
+bool JobObject::suspendJob(const bool &suspend)
+{
+	if(!m_hJobObject)
+	{
+		qWarning("Cannot suspend/resume job: No job object available!");
+		return false;
+	}
+
+	QMutexLocker lock(&m_mutex);
+
+	//Freezing the job as a whole is atomic, i.e. processes created concurrently can not escape
+	if(m_frozen)
+	{
+		if((!suspend) && (!freezeJob(false)))
+		{
+			qWarning("Failed to thaw the job object!");
+			return false;
+		}
+		m_frozen = suspend;
+		return true;
+	}
+	if(suspend && m_suspendedProcesses.isEmpty() && freezeJob(true))
+	{
+		m_frozen = true;
+		return true;
+	}
+
+	static const NtSuspendResumeProcessFun ntSuspendProcess = reinterpret_cast<NtSuspendResumeProcessFun>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtSuspendProcess"));
+	static const NtSuspendResumeProcessFun ntResumeProcess  = reinterpret_cast<NtSuspendResumeProcessFun>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtResumeProcess"));
+	if(!(ntSuspendProcess && ntResumeProcess))
+	{
+		qWarning("NtSuspendProcess/NtResumeProcess entry points not found!");
+		return false;
+	}
+
+	bool success = true;
+
+	if(suspend)
+	{
+		/*
+		 * Suspending the processes one by one is not atomic: A process that is not suspended yet may create a
+		 * new child in the meantime. Therefore, the process list is queried again, until it no longer contains
+		 * any process that has not been suspended. Processes beyond MAX_PROCESS_IDS can not be reached at all.
+		 */
+		bool stable = false;
+		for(int pass = 0; (pass < MAX_SUSPEND_PASSES) && (!stable); pass++)
+		{
+			QList<quint32> processIds;
+			bool truncated = false;
+			if(!getProcessIds(processIds, &truncated))
+			{
+				return false;
+			}
+			if(truncated)
+			{
+				qWarning("Job has more than %u processes, not all of them can be suspended!", MAX_PROCESS_IDS);
+				success = false;
+			}
+			stable = true;
+			for(QList<quint32>::ConstIterator iter = processIds.constBegin(); iter != processIds.constEnd(); iter++)
+			{
+				if(m_suspendedProcesses.contains(*iter))
+				{
+					continue; /*already suspended*/
+				}
+				stable = false;
+				const HANDLE hProcess = OpenProcess(PROCESS_SUSPEND_RESUME, FALSE, static_cast<DWORD>(*iter));
+				if(hProcess != NULL)
+				{
+					if(ntSuspendProcess(hProcess) >= 0)
+					{
+						m_suspendedProcesses << (*iter);
+					}
+					else
+					{
+						qWarning("Failed to suspend process #%u!", *iter);
+						success = false;
+					}
+					CloseHandle(hProcess);
+				}
+			}
+		}
+		if(!stable)
+		{
+			qWarning("Process list of job did not settle, some processes may still be running!");
+			success = false;
+		}
+	}
+	else
+	{
+		while(!m_suspendedProcesses.isEmpty())
+		{
+			const quint32 processId = m_suspendedProcesses.takeFirst();
+			const HANDLE hProcess = OpenProcess(PROCESS_SUSPEND_RESUME, FALSE, static_cast<DWORD>(processId));
+			if(hProcess != NULL)
+			{
+				if(ntResumeProcess(hProcess) < 0)
+				{
+					qWarning("Failed to resume process #%u!", processId);
+					success = false;
+				}
+				CloseHandle(hProcess);
+			}
+		}
+	}
+
+	return success;
+}
+
+void JobObject::sampleMemoryUsage(const bool &force)
+{
+	if(!m_hJobObject)
+	{
+		return;
+	}
+
+	//Samples are taken by the job list's timer as well as on demand, from different threads
+	QMutexLocker lock(&m_mutexSample);
+	const DWORD currentTime = GetTickCount();
+	if((!force) && (m_lastSampleTime != 0) && ((currentTime - m_lastSampleTime) < SAMPLE_INTERVAL))
+	{
+		return;
+	}
+
+	m_lastSampleTime = currentTime;
+
+	QList<quint32> processIds;
+	if(!getProcessIds(processIds))
+	{
+		return;
+	}
+
+	unsigned long long currentWorkingSet = 0;
+	for(QList<quint32>::ConstIterator iter = processIds.constBegin(); iter != processIds.constEnd(); iter++)
+	{
+		const HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, static_cast<DWORD>(*iter));
+		if(hProcess != NULL)
+		{
+			PROCESS_MEMORY_COUNTERS memoryCounters;
+			memset(&memoryCounters, 0, sizeof(PROCESS_MEMORY_COUNTERS));
+			if(GetProcessMemoryInfo(hProcess, &memoryCounters, sizeof(PROCESS_MEMORY_COUNTERS)))
+			{
+				currentWorkingSet += memoryCounters.WorkingSetSize;
+				m_peakWorkingSet = qMax(m_peakWorkingSet, static_cast<unsigned long long>(memoryCounters.PeakWorkingSetSize));
+			}
+			CloseHandle(hProcess);
+		}
+	}
+
+	m_peakWorkingSet = qMax(m_peakWorkingSet, currentWorkingSet);
+}
+
+bool JobObject::queryStatistics(JobStatistics &stats)
+{
+	if(!m_hJobObject)
+	{
+		qWarning("Cannot query job statistics: No job object available!");
+		return false;
+	}
+
+	JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION accountingInfo;
+	memset(&accountingInfo, 0, sizeof(JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION));
+	if(!QueryInformationJobObject(m_hJobObject, JobObjectBasicAndIoAccountingInformation, &accountingInfo, sizeof(JOBOBJECT_BASIC_AND_IO_ACCOUNTING_INFORMATION), NULL))
+	{
+		qWarning("Failed to query accounting information of job object!");
+		return false;
+	}
+
+	JOBOBJECT_EXTENDED_LIMIT_INFORMATION jobExtendedLimitInfo;
+	memset(&jobExtendedLimitInfo, 0, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION));
+	if(!QueryInformationJobObject(m_hJobObject, JobObjectExtendedLimitInformation, &jobExtendedLimitInfo, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION), NULL))
+	{
+		qWarning("Failed to query extended limit information of job object!");
+		return false;
+	}
+
+	sampleMemoryUsage(true);
+	QMutexLocker lock(&m_mutexSample);
+
+	//CPU times are reported in units of 100 nanoseconds
+	stats.userTime        = static_cast<quint64>(accountingInfo.BasicInfo.TotalUserTime.QuadPart)   / 10000ULL;
+	stats.kernelTime      = static_cast<quint64>(accountingInfo.BasicInfo.TotalKernelTime.QuadPart) / 10000ULL;
+	stats.peakWorkingSet  = m_peakWorkingSet;
+	stats.peakCommitted   = jobExtendedLimitInfo.PeakJobMemoryUsed;
+	stats.readBytes       = accountingInfo.IoInfo.ReadTransferCount;
+	stats.writeBytes      = accountingInfo.IoInfo.WriteTransferCount;
+	stats.readOperations  = accountingInfo.IoInfo.ReadOperationCount;
+	stats.writeOperations = accountingInfo.IoInfo.WriteOperationCount;
+	stats.processCount    = accountingInfo.BasicInfo.TotalProcesses;
+
+	return true;
+}
+
+bool JobObject::getProcessInfo(QStringList &info)
+{
+	if(!m_hJobObject)
+	{
+		qWarning("Cannot query process info: No job object available!");
+		return false;
+	}
+
+	QList<quint32> processIds;
+	if(!getProcessIds(processIds))
+	{
+		return false;
+	}
+
+	const HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+	if(hSnapshot == INVALID_HANDLE_VALUE)
+	{
+		qWarning("Failed to create process snapshot!");
+		return false;
+	}
+
+	PROCESSENTRY32W processEntry;
+	memset(&processEntry, 0, sizeof(PROCESSENTRY32W));
+	processEntry.dwSize = sizeof(PROCESSENTRY32W);
+
+	for(BOOL ok = Process32FirstW(hSnapshot, &processEntry); ok; ok = Process32NextW(hSnapshot, &processEntry))
+	{
+		if(!processIds.contains(processEntry.th32ProcessID))
+		{
+			continue;
+		}
+
+		QString details = QString("#%1 %2, %3 threads").arg(QString::number(processEntry.th32ProcessID), QString::fromWCharArray(processEntry.szExeFile), QString::number(processEntry.cntThreads));
+		const HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processEntry.th32ProcessID);
+		if(hProcess != NULL)
+		{
+			FILETIME creationTime, exitTime, kernelTime, userTime;
+			if(GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime))
+			{
+				const quint64 userMsec   = ((quint64(userTime.dwHighDateTime)   << 32) | quint64(userTime.dwLowDateTime))   / 10000ULL;
+				const quint64 kernelMsec = ((quint64(kernelTime.dwHighDateTime) << 32) | quint64(kernelTime.dwLowDateTime)) / 10000ULL;
+				details += QString(", CPU time %1/%2 msec").arg(QString::number(userMsec), QString::number(kernelMsec));
+			}
+			PROCESS_MEMORY_COUNTERS memoryCounters;
+			memset(&memoryCounters, 0, sizeof(PROCESS_MEMORY_COUNTERS));
+			if(GetProcessMemoryInfo(hProcess, &memoryCounters, sizeof(PROCESS_MEMORY_COUNTERS)))
+			{
+				details += QString(", working set %1 KB").arg(QString::number(quint64(memoryCounters.WorkingSetSize) / 1024ULL));
+			}
+			CloseHandle(hProcess);
+		}
+
+		info << details;
+	}
+
+	CloseHandle(hSnapshot);
+	return true;
+}
+
+bool JobObject::setIoPriority(const int &ioPriority)
+{
+	if(!m_hJobObject)
+	{
+		qWarning("Cannot set I/O priority: No job object available!");
+		return false;
+	}
+
+	QMutexLocker lock(&m_mutex);
+	const int newPriority = qBound(-2, ioPriority, 0);
+	if(m_ioPriority == newPriority)
+	{
+		return true;
+	}
+
+	m_ioPriority = newPriority;
+
+	QList<quint32> processIds;
+	if(!getProcessIds(processIds))
+	{
+		return false;
+	}
+
+	bool success = true;
+	for(QList<quint32>::ConstIterator iter = processIds.constBegin(); iter != processIds.constEnd(); iter++)
+	{
+		const HANDLE hProcess = OpenProcess(PROCESS_SET_INFORMATION, FALSE, static_cast<DWORD>(*iter));
+		if(hProcess != NULL)
+		{
+			success = applyIoPriority(hProcess, m_ioPriority) && success;
+			CloseHandle(hProcess);
+		}
+	}
+
+	return success;
+}
+
+bool JobObject::setIoRateLimit(const unsigned int &maxBandwidth)
+{
+	if(!m_hJobObject)
+	{
+		qWarning("Cannot set I/O rate limit: No job object available!");
+		return false;
+	}
+
+	static const SetIoRateControlInformationJobObjectFun setIoRateControlInformationJobObject = reinterpret_cast<SetIoRateControlInformationJobObjectFun>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetIoRateControlInformationJobObject"));
+	if(!setIoRateControlInformationJobObject)
+	{
+		if(maxBandwidth > 0)
+		{
+			qWarning("I/O rate control is not supported on this platform!");
+		}
+		return false;
+	}
+
+	//A NULL volume name applies the limit to all volumes
+	IO_RATE_CONTROL_INFO rateControlInfo;
+	memset(&rateControlInfo, 0, sizeof(IO_RATE_CONTROL_INFO));
+	rateControlInfo.MaxBandwidth = static_cast<LONG64>(maxBandwidth) * 1048576LL;
+	rateControlInfo.ControlFlags = (maxBandwidth > 0) ? IO_RATE_CONTROL_ENABLE : 0;
+
+	if(setIoRateControlInformationJobObject(m_hJobObject, &rateControlInfo) == 0)
+	{
+		qWarning("Failed to set I/O rate limit of job object!");
+		return false;
+	}
+
+	return true;
+}
+
+bool JobObject::getProcessIds(QList<quint32> &processIds, bool *const truncated)
+{
+	BYTE buffer[sizeof(JOBOBJECT_BASIC_PROCESS_ID_LIST) + (MAX_PROCESS_IDS * sizeof(ULONG_PTR))];
+	memset(buffer, 0, sizeof(buffer));
+	JOBOBJECT_BASIC_PROCESS_ID_LIST *const processIdList = reinterpret_cast<JOBOBJECT_BASIC_PROCESS_ID_LIST*>(buffer);
+	processIdList->NumberOfAssignedProcesses = MAX_PROCESS_IDS;
+
+	if(!QueryInformationJobObject(m_hJobObject, JobObjectBasicProcessIdList, processIdList, sizeof(buffer), NULL))
+	{
+		if(GetLastError() != ERROR_MORE_DATA)
+		{
+			qWarning("Failed to query process list of job object!");
+			return false;
+		}
+	}
+
+	for(DWORD i = 0; i < processIdList->NumberOfProcessIdsInList; i++)
+	{
+		processIds << static_cast<quint32>(processIdList->ProcessIdList[i]);
+	}
+
+	if(truncated)
+	{
+		*truncated = (processIdList->NumberOfAssignedProcesses > processIdList->NumberOfProcessIdsInList);
+	}
+
+	return true;
+}
+
+bool JobObject::freezeJob(const bool &freeze)
+{
+	static const NtSetInformationJobObjectFun ntSetInformationJobObject = reinterpret_cast<NtSetInformationJobObjectFun>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtSetInformationJobObject"));
+	if(!ntSetInformationJobObject)
+	{
+		return false;
+	}
+
+	JOBOBJECT_FREEZE_INFO freezeInfo;
+	memset(&freezeInfo, 0, sizeof(JOBOBJECT_FREEZE_INFO));
+	freezeInfo.Flags = 0x1;
+	freezeInfo.Freeze = freeze ? TRUE : FALSE;
+
+	//Not supported on older versions of Windows, or without sufficient privileges
+	return (ntSetInformationJobObject(m_hJobObject, JOB_OBJECT_FREEZE_INFORMATION, &freezeInfo, sizeof(JOBOBJECT_FREEZE_INFO)) >= 0);
+}
+
+bool JobObject::applyIoPriority(void *const hProcess, const int &ioPriority)
+{
+	static const NtSetInformationProcessFun ntSetInformationProcess = reinterpret_cast<NtSetInformationProcessFun>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtSetInformationProcess"));
+	if(!ntSetInformationProcess)
+	{
+		return false;
+	}
+
+	//Map to IoPriorityVeryLow (0), IoPriorityLow (1) or IoPriorityNormal (2)
+	ULONG ioPriorityHint = static_cast<ULONG>(qBound(-2, ioPriority, 0) + 2);
+	if(ntSetInformationProcess(hProcess, PROCESS_INFO_IO_PRIORITY, &ioPriorityHint, sizeof(ULONG)) < 0)
+	{
+		qWarning("Failed to set I/O priority of process!");
+		return false;
+	}
+
+	return true;
+}
@@ -22,7 +22,12 @@
 
 #pragma once
 
+#include <QMutex>
+#include <QList>
+#include <QStringList>
+
 class QProcess;
+struct JobStatistics;
 
 class JobObject
 {
@@ -32,7 +37,30 @@ public:
 
 	bool addProcessToJob(const QProcess *proc);
 	bool terminateJob(unsigned int exitCode = -1);
+	bool suspendJob(const bool &suspend);
+	bool setKillOnClose(const bool &enabled);
+	quint32 getLastProcessId(void);
+
+	void sampleMemoryUsage(const bool &force = false);
+	bool queryStatistics(JobStatistics &stats);
+	bool getProcessInfo(QStringList &info);
+
+	bool setIoPriority(const int &ioPriority);
+	bool setIoRateLimit(const unsigned int &maxBandwidth);
 
 private:
+	bool getProcessIds(QList<quint32> &processIds, bool *const truncated = NULL);
+	bool freezeJob(const bool &freeze);
+	static bool applyIoPriority(void *const hProcess, const int &ioPriority);
+
 	void *m_hJobObject;
+	QMutex m_mutex;
+	QMutex m_mutexSample;
+	int m_ioPriority;
+	QList<quint32> m_suspendedProcesses;
+	bool m_frozen;
+	quint32 m_lastProcessId;
+
+	unsigned long long m_peakWorkingSet;
+	unsigned long m_lastSampleTime;
 };
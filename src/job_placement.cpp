@@ -0,0 +1,348 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "job_placement.h"
+
+#include "global.h"
+
+//MUtils
+#include <MUtils/OSSupport.h>
+
+//Qt
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+#include <QElapsedTimer>
+
+//Windows includes
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+static const char *KEY_POOLS   = "pools";
+static const char *KEY_PATH    = "path";
+static const char *KEY_VOLUMES = "volumes";
+
+//Free space that is always kept on each volume, in addition to the estimate
+static const qint64 MIN_RESERVE = Q_INT64_C(1073741824);
+
+//Reservation for jobs whose output size is not known yet (piped sources), until updateEstimate() is called
+static const qint64 UNKNOWN_ESTIMATE = Q_INT64_C(4294967296);
+
+//Weight of the most recent throughput sample
+static const double THROUGHPUT_ALPHA = 0.3;
+
+//Size of the write probe that is used for volumes without a throughput sample
+static const DWORD  PROBE_CHUNK_SIZE = 4194304U;
+static const qint64 PROBE_TOTAL_SIZE = Q_INT64_C(33554432);
+
+static inline QString PATH_KEY(const QString &path)
+{
+	return QDir::fromNativeSeparators(QDir::cleanPath(QFileInfo(path).absoluteFilePath())).toLower();
+}
+
+QMutex                                     OutputPlacement::s_mutex;
+QString                                    OutputPlacement::s_identity;
+QMap<QString, QStringList>                 OutputPlacement::s_pools;
+QMap<QString, OutputPlacement::volume_t>   OutputPlacement::s_volumes;
+QMap<QUuid, OutputPlacement::placement_t>  OutputPlacement::s_placed;
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Must be called from the job's thread: Volumes without a throughput sample are probed, which takes a while
+ */
+QString OutputPlacement::place(const QUuid &jobId, const QString &outputFile, const qint64 &estimatedSize)
+{
+	const QFileInfo outputInfo(outputFile);
+	QStringList volumes, unprobed;
+
+	//Volumes that have not been written to yet are probed once, other jobs assume the average until the result is in
+	{
+		QMutexLocker lock(&s_mutex);
+		reload();
+		volumes = s_pools.value(PATH_KEY(outputInfo.absolutePath()));
+		if(volumes.isEmpty() || s_placed.contains(jobId))
+		{
+			return QString();
+		}
+		for(QStringList::ConstIterator iter = volumes.constBegin(); iter != volumes.constEnd(); iter++)
+		{
+			volume_t &volume = s_volumes[PATH_KEY(*iter)];
+			if((volume.throughput <= 0.0) && (!volume.probed))
+			{
+				volume.probed = true;
+				unprobed << (*iter);
+			}
+		}
+	}
+
+	//The lock is not held while probing, so that other jobs can still report their samples
+	for(QStringList::ConstIterator iter = unprobed.constBegin(); iter != unprobed.constEnd(); iter++)
+	{
+		const double throughput = QDir(*iter).exists() ? measureThroughput(*iter) : 0.0;
+		QMutexLocker lock(&s_mutex);
+		volume_t &volume = s_volumes[PATH_KEY(*iter)];
+		if(volume.throughput <= 0.0)
+		{
+			volume.throughput = throughput;
+		}
+	}
+
+	QMutexLocker lock(&s_mutex);
+	double averageThroughput = 0.0;
+	int samples = 0;
+	for(QStringList::ConstIterator iter = volumes.constBegin(); iter != volumes.constEnd(); iter++)
+	{
+		const volume_t &volume = s_volumes[PATH_KEY(*iter)];
+		if(volume.throughput > 0.0)
+		{
+			averageThroughput += volume.throughput;
+			samples++;
+		}
+	}
+	averageThroughput = (samples > 0) ? (averageThroughput / double(samples)) : 1.0;
+
+	//Pick the volume with the best combination of free space and the throughput that each job gets
+	const qint64 required = (estimatedSize > 0) ? estimatedSize : UNKNOWN_ESTIMATE;
+	QString bestVolume;
+	double bestScore = 0.0;
+	for(QStringList::ConstIterator iter = volumes.constBegin(); iter != volumes.constEnd(); iter++)
+	{
+		quint64 freeSpace = 0;
+		if(!(QDir(*iter).exists() && MUtils::OS::free_diskspace(*iter, freeSpace)))
+		{
+			continue;
+		}
+		const volume_t volume = s_volumes.value(PATH_KEY(*iter));
+		const qint64 available = qint64(freeSpace) - volume.reserved - MIN_RESERVE;
+		if(available < (required + (required / 8)))
+		{
+			continue;
+		}
+		const double throughput = (volume.throughput > 0.0) ? volume.throughput : averageThroughput;
+		const double score = (throughput / double(volume.activeJobs + 1)) * double(available);
+		if(bestVolume.isEmpty() || (score > bestScore))
+		{
+			bestVolume = *iter;
+			bestScore = score;
+		}
+	}
+
+	if(bestVolume.isEmpty())
+	{
+		return QString();
+	}
+
+	//Reserve the estimated size and the file name, until the job has finished
+	volume_t &volume = s_volumes[PATH_KEY(bestVolume)];
+	volume.activeJobs++;
+	volume.reserved += required;
+
+	placement_t placement;
+	placement.volume = PATH_KEY(bestVolume);
+	placement.outputFile = makeUnique(bestVolume, outputInfo.fileName());
+	placement.reserved = required;
+	s_placed.insert(jobId, placement);
+
+	return placement.outputFile;
+}
+
+void OutputPlacement::updateEstimate(const QUuid &jobId, const qint64 &estimatedSize)
+{
+	QMutexLocker lock(&s_mutex);
+
+	if(s_placed.contains(jobId) && (estimatedSize > 0))
+	{
+		placement_t &placement = s_placed[jobId];
+		volume_t &volume = s_volumes[placement.volume];
+		volume.reserved = qMax(volume.reserved - placement.reserved + estimatedSize, Q_INT64_C(0));
+		placement.reserved = estimatedSize;
+	}
+}
+
+/*
+ * The duration must only cover the actual writes to the volume, not the time spent encoding
+ */
+void OutputPlacement::addWriteSample(const QUuid &jobId, const qint64 &bytesWritten, const qint64 &duration)
+{
+	QMutexLocker lock(&s_mutex);
+
+	if(s_placed.contains(jobId))
+	{
+		updateThroughput(s_volumes[s_placed.value(jobId).volume], bytesWritten, duration);
+	}
+}
+
+/*
+ * The encoder's writes go through the file system cache and are interleaved with encoding, so their rate is only
+ * a lower bound of what the volume can do: The throughput is raised to it, but never lowered by it
+ */
+void OutputPlacement::addOutputSample(const QUuid &jobId, const qint64 &bytesWritten, const qint64 &duration)
+{
+	QMutexLocker lock(&s_mutex);
+
+	if(s_placed.contains(jobId) && (bytesWritten > 0) && (duration > 0))
+	{
+		volume_t &volume = s_volumes[s_placed.value(jobId).volume];
+		volume.throughput = qMax(volume.throughput, double(bytesWritten) / (double(duration) / 1000.0));
+	}
+}
+
+void OutputPlacement::release(const QUuid &jobId)
+{
+	QMutexLocker lock(&s_mutex);
+
+	if(s_placed.contains(jobId))
+	{
+		const placement_t placement = s_placed.take(jobId);
+		volume_t &volume = s_volumes[placement.volume];
+		volume.activeJobs = qMax(volume.activeJobs - 1, 0);
+		volume.reserved = qMax(volume.reserved - placement.reserved, Q_INT64_C(0));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal Functions
+///////////////////////////////////////////////////////////////////////////////
+
+void OutputPlacement::reload(void)
+{
+	const QString configFile = getConfigFile();
+	const QString identity = x264_file_identity(configFile);
+
+	if(identity == s_identity)
+	{
+		return; /*not modified*/
+	}
+
+	s_identity = identity;
+	s_pools.clear();
+
+	if(identity.isEmpty())
+	{
+		return; /*no pools configured*/
+	}
+
+	QSettings settings(configFile, QSettings::IniFormat);
+	const int count = settings.beginReadArray(KEY_POOLS);
+	for(int i = 0; i < count; i++)
+	{
+		settings.setArrayIndex(i);
+		const QString path = settings.value(KEY_PATH).toString().trimmed();
+		const QStringList volumes = settings.value(KEY_VOLUMES).toStringList();
+		QStringList validVolumes;
+		for(QStringList::ConstIterator iter = volumes.constBegin(); iter != volumes.constEnd(); iter++)
+		{
+			if(!iter->trimmed().isEmpty())
+			{
+				validVolumes << QDir::fromNativeSeparators(iter->trimmed());
+			}
+		}
+		if((!path.isEmpty()) && (!validVolumes.isEmpty()))
+		{
+			s_pools.insert(PATH_KEY(path), validVolumes);
+		}
+	}
+	settings.endArray();
+}
+
+QString OutputPlacement::getConfigFile(void)
+{
+	return QString("%1/placement.ini").arg(x264_data_path());
+}
+
+QString OutputPlacement::makeUnique(const QString &directory, const QString &fileName)
+{
+	const QFileInfo info(fileName);
+	QString outputFile = QString("%1/%2").arg(directory, fileName);
+	int counter = 1;
+
+	//The file is not created until the encoder starts, so names that have been handed out already must be skipped too
+	while(QFileInfo(outputFile).exists() || isReserved(outputFile))
+	{
+		outputFile = QString("%1/%2_%3.%4").arg(directory, info.completeBaseName(), QString::number(++counter), info.suffix());
+	}
+
+	return outputFile;
+}
+
+bool OutputPlacement::isReserved(const QString &outputFile)
+{
+	const QString key = PATH_KEY(outputFile);
+	for(QMap<QUuid, placement_t>::ConstIterator iter = s_placed.constBegin(); iter != s_placed.constEnd(); iter++)
+	{
+		if(PATH_KEY(iter->outputFile) == key)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void OutputPlacement::updateThroughput(volume_t &volume, const qint64 &bytesWritten, const qint64 &duration)
+{
+	if((bytesWritten > 0) && (duration > 0))
+	{
+		const double throughput = double(bytesWritten) / (double(duration) / 1000.0);
+		volume.throughput = (volume.throughput > 0.0) ? ((THROUGHPUT_ALPHA * throughput) + ((1.0 - THROUGHPUT_ALPHA) * volume.throughput)) : throughput;
+	}
+}
+
+/*
+ * Writes a small unbuffered probe file, so the result reflects the volume rather than the file system cache
+ */
+double OutputPlacement::measureThroughput(const QString &directory)
+{
+	const QString probeFile = QString("%1/~%2.tmp").arg(directory, QUuid::createUuid().toString().mid(1, 36));
+	const HANDLE hFile = CreateFileW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(probeFile).utf16()), GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		return 0.0;
+	}
+
+	volume_t volume = { 0, 0, 0.0, true };
+	char *const buffer = static_cast<char*>(VirtualAlloc(NULL, PROBE_CHUNK_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+	if(buffer)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		qint64 written = 0;
+		while(written < PROBE_TOTAL_SIZE)
+		{
+			DWORD bytesWritten = 0;
+			if(!(WriteFile(hFile, buffer, PROBE_CHUNK_SIZE, &bytesWritten, NULL) && (bytesWritten == PROBE_CHUNK_SIZE)))
+			{
+				written = 0;
+				break;
+			}
+			written += bytesWritten;
+		}
+		updateThroughput(volume, written, qMax(timer.elapsed(), Q_INT64_C(1)));
+		VirtualFree(buffer, 0, MEM_RELEASE);
+	}
+
+	CloseHandle(hFile);
+	return volume.throughput;
+}
@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QMutex>
+#include <QMap>
+#include <QUuid>
+
+class OutputPlacement
+{
+public:
+	static QString place(const QUuid &jobId, const QString &outputFile, const qint64 &estimatedSize);
+	static void updateEstimate(const QUuid &jobId, const qint64 &estimatedSize);
+	static void addWriteSample(const QUuid &jobId, const qint64 &bytesWritten, const qint64 &duration);
+	static void addOutputSample(const QUuid &jobId, const qint64 &bytesWritten, const qint64 &duration);
+	static void release(const QUuid &jobId);
+
+protected:
+	typedef struct
+	{
+		int activeJobs;
+		qint64 reserved;
+		double throughput;
+		bool probed;
+	}
+	volume_t;
+
+	typedef struct
+	{
+		QString volume;
+		QString outputFile;
+		qint64 reserved;
+	}
+	placement_t;
+
+	static void reload(void);
+	static QString getConfigFile(void);
+	static QString makeUnique(const QString &directory, const QString &fileName);
+	static bool isReserved(const QString &outputFile);
+	static void updateThroughput(volume_t &volume, const qint64 &bytesWritten, const qint64 &duration);
+	static double measureThroughput(const QString &directory);
+
+	static QMutex s_mutex;
+	static QString s_identity;
+	static QMap<QString, QStringList> s_pools;
+	static QMap<QString, volume_t> s_volumes;
+	static QMap<QUuid, placement_t> s_placed;
+};
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "job_render.h"
+
+//Internal
+#include "global.h"
+
+//Qt
+#include <QFileInfo>
+
+//CRT
+#include <stdlib.h>
+
+/*
+ * The spool is a ring buffer of fixed capacity, backed by a temporary file
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+RenderSpool::RenderSpool(const QString &fileName, const qint64 &capacity)
+:
+	m_fileName(fileName),
+	m_capacity(qMax(capacity, Q_INT64_C(1048576))),
+	m_priority(0),
+	m_readPos(0),
+	m_writePos(0),
+	m_attached(false),
+	m_cancelled(false),
+	m_finished(false),
+	m_exitCode(EXIT_SUCCESS)
+{
+}
+
+RenderSpool::~RenderSpool(void)
+{
+	if(m_file.isOpen())
+	{
+		m_file.close();
+	}
+	if(QFileInfo(m_fileName).exists())
+	{
+		QFile::remove(m_fileName);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Source command
+///////////////////////////////////////////////////////////////////////////////
+
+void RenderSpool::setCommand(const QString &program, const QStringList &args, const QStringList &extraPaths, const QHash<QString, QString> &extraEnv, const int &priority)
+{
+	m_program = program;
+	m_args = args;
+	m_extraPaths = extraPaths;
+	m_extraEnv = extraEnv;
+	m_priority = priority;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Producer
+///////////////////////////////////////////////////////////////////////////////
+
+bool RenderSpool::open(void)
+{
+	QMutexLocker lock(&m_mutex);
+	m_file.setFileName(m_fileName);
+	return m_file.open(QIODevice::ReadWrite | QIODevice::Truncate | QIODevice::Unbuffered);
+}
+
+qint64 RenderSpool::getFreeSpace(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_capacity - qint64(m_writePos - m_readPos);
+}
+
+bool RenderSpool::write(const QByteArray &data)
+{
+	QMutexLocker lock(&m_mutex);
+
+	const qint64 length = data.size();
+	if((length > m_capacity - qint64(m_writePos - m_readPos)) || (!m_file.isOpen()))
+	{
+		return false;
+	}
+
+	//Write the data, wrapping around at the end of the file
+	const qint64 offset = qint64(m_writePos % quint64(m_capacity));
+	const qint64 head = qMin(length, m_capacity - offset);
+	if((!m_file.seek(offset)) || (m_file.write(data.constData(), head) != head))
+	{
+		return false;
+	}
+	if(head < length)
+	{
+		if((!m_file.seek(0)) || (m_file.write(data.constData() + head, length - head) != (length - head)))
+		{
+			return false;
+		}
+	}
+
+	m_writePos += quint64(length);
+	m_dataReady.wakeAll();
+	return true;
+}
+
+void RenderSpool::finish(const int &exitCode, const QString &messages)
+{
+	QMutexLocker lock(&m_mutex);
+	m_finished = true;
+	m_exitCode = exitCode;
+	m_messages = messages;
+	m_dataReady.wakeAll();
+}
+
+bool RenderSpool::isAttached(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_attached;
+}
+
+bool RenderSpool::isCancelled(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_cancelled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Consumer
+///////////////////////////////////////////////////////////////////////////////
+
+bool RenderSpool::attach(void)
+{
+	QMutexLocker lock(&m_mutex);
+
+	if(m_cancelled || m_attached || (m_finished && (m_exitCode != EXIT_SUCCESS)))
+	{
+		return false;
+	}
+
+	m_attached = true;
+	return true;
+}
+
+qint64 RenderSpool::read(QByteArray &buffer, const qint64 &maxSize, const unsigned long &timeout)
+{
+	QMutexLocker lock(&m_mutex);
+
+	while((m_readPos == m_writePos) && (!m_finished) && (!m_cancelled))
+	{
+		if(!m_dataReady.wait(&m_mutex, timeout))
+		{
+			return 0;
+		}
+	}
+
+	if((m_readPos == m_writePos) || m_cancelled)
+	{
+		return -1; /*end of stream*/
+	}
+
+	//Read the data, wrapping around at the end of the file
+	const qint64 length = qMin(maxSize, qint64(m_writePos - m_readPos));
+	const qint64 offset = qint64(m_readPos % quint64(m_capacity));
+	const qint64 head = qMin(length, m_capacity - offset);
+
+	buffer.resize(int(length));
+	if((!m_file.seek(offset)) || (m_file.read(buffer.data(), head) != head))
+	{
+		return -1;
+	}
+	if(head < length)
+	{
+		if((!m_file.seek(0)) || (m_file.read(buffer.data() + head, length - head) != (length - head)))
+		{
+			return -1;
+		}
+	}
+
+	m_readPos += quint64(length);
+	return length;
+}
+
+void RenderSpool::cancel(void)
+{
+	QMutexLocker lock(&m_mutex);
+	m_cancelled = true;
+	m_dataReady.wakeAll();
+}
+
+int RenderSpool::getExitCode(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_exitCode;
+}
+
+QString RenderSpool::getMessages(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_messages;
+}
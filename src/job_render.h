@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+
+class RenderSpool
+{
+public:
+	RenderSpool(const QString &fileName, const qint64 &capacity);
+	~RenderSpool(void);
+
+	//Source command
+	void setCommand(const QString &program, const QStringList &args, const QStringList &extraPaths, const QHash<QString, QString> &extraEnv, const int &priority);
+	const QString &getProgram(void) const { return m_program; }
+	const QStringList &getArgs(void) const { return m_args; }
+	const QStringList &getExtraPaths(void) const { return m_extraPaths; }
+	const QHash<QString, QString> &getExtraEnv(void) const { return m_extraEnv; }
+	int getPriority(void) const { return m_priority; }
+	const qint64 &getCapacity(void) const { return m_capacity; }
+
+	//Producer
+	bool open(void);
+	qint64 getFreeSpace(void);
+	bool write(const QByteArray &data);
+	void finish(const int &exitCode, const QString &messages);
+	bool isAttached(void);
+	bool isCancelled(void);
+
+	//Consumer
+	bool attach(void);
+	qint64 read(QByteArray &buffer, const qint64 &maxSize, const unsigned long &timeout);
+	void cancel(void);
+	int getExitCode(void);
+	QString getMessages(void);
+
+protected:
+	const QString m_fileName;
+	const qint64 m_capacity;
+
+	QString m_program;
+	QStringList m_args;
+	QStringList m_extraPaths;
+	QHash<QString, QString> m_extraEnv;
+	int m_priority;
+
+	QMutex m_mutex;
+	QWaitCondition m_dataReady;
+	QFile m_file;
+
+	quint64 m_readPos;
+	quint64 m_writePos;
+	bool m_attached;
+	bool m_cancelled;
+	bool m_finished;
+	int m_exitCode;
+	QString m_messages;
+};
@@ -0,0 +1,286 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "job_spool.h"
+
+#include "global.h"
+#include "model_options.h"
+#include "thread_log.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStringList>
+
+//Windows includes
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+static const char *KEY_SOURCE_FILE = "source_file";
+static const char *KEY_OUTPUT_FILE = "output_file";
+static const char *KEY_PROCESS_ID  = "process_id";
+static const char *KEY_PROCESS_CRT = "process_created";
+static const char *KEY_STDIN_FEED  = "stdin_feed";
+static const char *KEY_PASS        = "pass";
+static const char *KEY_FINAL_STAT  = "final_status";
+static const char *KEY_ENC_OPTIONS = "encoder_options";
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+JobSpool::JobSpool(const QUuid &jobId)
+:
+	m_jobId(jobId),
+	m_processId(0),
+	m_processCreationTime(0),
+	m_pass(0),
+	m_stdinFeed(false),
+	m_finalStatus(-1),
+	m_hProcess(NULL)
+{
+}
+
+JobSpool::~JobSpool(void)
+{
+	if(m_hProcess)
+	{
+		CloseHandle(m_hProcess);
+		m_hProcess = NULL;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Running job
+///////////////////////////////////////////////////////////////////////////////
+
+bool JobSpool::create(const QString &sourceFile, const QString &outputFile, const OptionsModel *const options, const bool &stdinFeed)
+{
+	const QString spoolDir = getSpoolDir();
+	if(!QDir(spoolDir).exists())
+	{
+		QDir().mkpath(spoolDir);
+	}
+
+	m_sourceFile = sourceFile;
+	m_outputFile = outputFile;
+	m_stdinFeed = stdinFeed;
+
+	QSettings settings(getFileName("ini"), QSettings::IniFormat);
+	settings.setValue(KEY_SOURCE_FILE, m_sourceFile);
+	settings.setValue(KEY_OUTPUT_FILE, m_outputFile);
+	settings.setValue(KEY_STDIN_FEED,  m_stdinFeed);
+
+	//Keep the options, so that a recovered job can be restarted
+	if(options)
+	{
+		settings.beginGroup(KEY_ENC_OPTIONS);
+		OptionsModel::saveOptions(options, settings);
+		settings.endGroup();
+	}
+
+	settings.sync();
+
+	if(settings.status() != QSettings::NoError)
+	{
+		qWarning("Failed to create spool file!");
+		return false;
+	}
+
+	return true;
+}
+
+void JobSpool::updateProcess(const quint32 &processId, const int &pass)
+{
+	if((processId == 0) || ((processId == m_processId) && (pass == m_pass)))
+	{
+		return;
+	}
+
+	const HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processId);
+	if(hProcess == NULL)
+	{
+		qWarning("Failed to open process #%u!", processId);
+		return;
+	}
+
+	m_processId = processId;
+	m_processCreationTime = getCreationTime(hProcess);
+	m_pass = pass;
+	CloseHandle(hProcess);
+
+	QSettings settings(getFileName("ini"), QSettings::IniFormat);
+	settings.setValue(KEY_PROCESS_ID,  m_processId);
+	settings.setValue(KEY_PROCESS_CRT, QString::number(m_processCreationTime));
+	settings.setValue(KEY_PASS,        m_pass);
+	settings.sync();
+}
+
+void JobSpool::remove(void)
+{
+	QFile::remove(getFileName("ini"));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Recovered job
+///////////////////////////////////////////////////////////////////////////////
+
+bool JobSpool::load(const SysinfoModel *const sysinfo)
+{
+	QSettings settings(getFileName("ini"), QSettings::IniFormat);
+	m_sourceFile = settings.value(KEY_SOURCE_FILE, QString()).toString().trimmed();
+	m_outputFile = settings.value(KEY_OUTPUT_FILE, QString()).toString().trimmed();
+	m_processId = settings.value(KEY_PROCESS_ID, 0U).toUInt();
+	m_processCreationTime = settings.value(KEY_PROCESS_CRT, QString()).toString().toULongLong();
+	m_pass = settings.value(KEY_PASS, 0).toInt();
+	m_stdinFeed = settings.value(KEY_STDIN_FEED, false).toBool();
+	m_finalStatus = settings.value(KEY_FINAL_STAT, -1).toInt();
+
+	if(m_sourceFile.isEmpty() || m_outputFile.isEmpty())
+	{
+		return false;
+	}
+
+	if(settings.childGroups().contains(KEY_ENC_OPTIONS))
+	{
+		m_options.reset(new OptionsModel(sysinfo));
+		settings.beginGroup(KEY_ENC_OPTIONS);
+		if(!OptionsModel::loadOptions(m_options.data(), settings))
+		{
+			m_options.reset();
+		}
+		settings.endGroup();
+	}
+
+	//The log has been streamed to disk by the log writer
+	m_logEntries = LogWriter::load(m_jobId);
+
+	return true;
+}
+
+bool JobSpool::attach(void)
+{
+	if(m_hProcess || (m_processId == 0))
+	{
+		return (m_hProcess != NULL);
+	}
+
+	const HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_TERMINATE | SYNCHRONIZE, FALSE, m_processId);
+	if(hProcess == NULL)
+	{
+		return false; /*process not running anymore*/
+	}
+
+	//Make sure the process ID has not been re-used in the meantime
+	if((getCreationTime(hProcess) != m_processCreationTime) || (WaitForSingleObject(hProcess, 0) != WAIT_TIMEOUT))
+	{
+		CloseHandle(hProcess);
+		return false;
+	}
+
+	m_hProcess = hProcess;
+	return true;
+}
+
+bool JobSpool::isRunning(void) const
+{
+	return m_hProcess && (WaitForSingleObject(m_hProcess, 0) == WAIT_TIMEOUT);
+}
+
+bool JobSpool::terminate(void)
+{
+	return m_hProcess && TerminateProcess(m_hProcess, 42);
+}
+
+int JobSpool::getExitCode(void) const
+{
+	DWORD exitCode = DWORD(-1);
+	if(m_hProcess)
+	{
+		if(!GetExitCodeProcess(m_hProcess, &exitCode))
+		{
+			exitCode = DWORD(-1);
+		}
+	}
+	return static_cast<int>(exitCode);
+}
+
+/*
+ * A successful exit code does not mean the encode is complete, if the application was feeding the encoder's stdin
+ * (the encoder sees an early end of input) or if only the first pass of a 2-pass encode had been started
+ */
+bool JobSpool::isIncomplete(void) const
+{
+	return m_stdinFeed || (m_pass == 1);
+}
+
+void JobSpool::finish(const int &status)
+{
+	m_finalStatus = status;
+
+	QSettings settings(getFileName("ini"), QSettings::IniFormat);
+	settings.setValue(KEY_FINAL_STAT, m_finalStatus);
+	settings.sync();
+}
+
+QList<QUuid> JobSpool::findOrphans(void)
+{
+	QList<QUuid> orphans;
+
+	const QFileInfoList files = QDir(getSpoolDir()).entryInfoList(QStringList() << "*.ini", QDir::Files, QDir::Time | QDir::Reversed);
+	for(QFileInfoList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		const QUuid jobId(QString("{%1}").arg(iter->completeBaseName()));
+		if(!jobId.isNull())
+		{
+			orphans << jobId;
+		}
+	}
+
+	return orphans;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal
+///////////////////////////////////////////////////////////////////////////////
+
+QString JobSpool::getFileName(const QString &suffix) const
+{
+	return QString("%1/%2.%3").arg(getSpoolDir(), m_jobId.toString().mid(1, 36), suffix);
+}
+
+QString JobSpool::getSpoolDir(void)
+{
+	return QString("%1/spool").arg(x264_data_path());
+}
+
+quint64 JobSpool::getCreationTime(void *const hProcess)
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if(GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime))
+	{
+		return (quint64(creationTime.dwHighDateTime) << 32) | quint64(creationTime.dwLowDateTime);
+	}
+	return 0;
+}
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "thread_log.h"
+
+#include <QString>
+#include <QUuid>
+#include <QList>
+#include <QScopedPointer>
+
+class OptionsModel;
+class SysinfoModel;
+
+class JobSpool
+{
+public:
+	typedef LogWriter::LogEntry LogEntry;
+
+	JobSpool(const QUuid &jobId);
+	~JobSpool(void);
+
+	//Running job
+	bool create(const QString &sourceFile, const QString &outputFile, const OptionsModel *const options, const bool &stdinFeed);
+	void updateProcess(const quint32 &processId, const int &pass);
+	void remove(void);
+
+	//Recovered job
+	bool load(const SysinfoModel *const sysinfo);
+	bool attach(void);
+	bool isRunning(void) const;
+	bool terminate(void);
+	int getExitCode(void) const;
+	bool isIncomplete(void) const;
+	void finish(const int &status);
+
+	const QString &getSourceFile(void) const { return m_sourceFile; }
+	const QString &getOutputFile(void) const { return m_outputFile; }
+	const OptionsModel *getOptions(void) const { return m_options.data(); }
+	const quint32 &getProcessId(void)  const { return m_processId;  }
+	const int &getPass(void) const { return m_pass; }
+	const bool &getStdinFeed(void) const { return m_stdinFeed; }
+	const int &getFinalStatus(void) const { return m_finalStatus; }
+	const QList<LogEntry> &getLogEntries(void) const { return m_logEntries; }
+
+	static QList<QUuid> findOrphans(void);
+
+protected:
+	QString getFileName(const QString &suffix) const;
+	static QString getSpoolDir(void);
+	static quint64 getCreationTime(void *const hProcess);
+
+	const QUuid m_jobId;
+
+	QString m_sourceFile;
+	QString m_outputFile;
+	QScopedPointer<OptionsModel> m_options;
+	quint32 m_processId;
+	quint64 m_processCreationTime;
+	int m_pass;
+	bool m_stdinFeed;
+	int m_finalStatus;
+
+	QList<LogEntry> m_logEntries;
+	void *m_hProcess;
+};
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "job_stage.h"
+
+//Qt
+#include <QFile>
+#include <QFileInfo>
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+InputStage::InputStage(const QString &sourceFile, const QString &stagedFile, const qint64 &size)
+:
+	m_sourceFile(sourceFile),
+	m_stagedFile(stagedFile),
+	m_size(size),
+	m_state(STAGE_PENDING)
+{
+}
+
+InputStage::~InputStage(void)
+{
+	if(QFileInfo(m_stagedFile).exists())
+	{
+		QFile::remove(m_stagedFile);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+InputStage::state_t InputStage::getState(void)
+{
+	QMutexLocker lock(&m_mutex);
+	return m_state;
+}
+
+void InputStage::setState(const state_t &state)
+{
+	QMutexLocker lock(&m_mutex);
+	if(m_state != STAGE_CANCELLED)
+	{
+		m_state = state;
+		m_stateChanged.wakeAll();
+	}
+}
+
+bool InputStage::waitForReady(volatile bool *abort)
+{
+	QMutexLocker lock(&m_mutex);
+
+	while((m_state == STAGE_PENDING) || (m_state == STAGE_COPYING))
+	{
+		if(abort && (*abort))
+		{
+			return false;
+		}
+		m_stateChanged.wait(&m_mutex, 1000);
+	}
+
+	return (m_state == STAGE_READY);
+}
+
+void InputStage::cancel(void)
+{
+	QMutexLocker lock(&m_mutex);
+	m_state = STAGE_CANCELLED;
+	m_stateChanged.wakeAll();
+}
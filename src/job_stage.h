@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+
+class InputStage
+{
+public:
+	typedef enum
+	{
+		STAGE_PENDING   = 0,
+		STAGE_COPYING   = 1,
+		STAGE_READY     = 2,
+		STAGE_FAILED    = 3,
+		STAGE_CANCELLED = 4
+	}
+	state_t;
+
+	InputStage(const QString &sourceFile, const QString &stagedFile, const qint64 &size);
+	~InputStage(void);
+
+	const QString &getSourceFile(void) const { return m_sourceFile; }
+	const QString &getStagedFile(void) const { return m_stagedFile; }
+	const qint64 &getSize(void) const { return m_size; }
+
+	state_t getState(void);
+	void setState(const state_t &state);
+	bool waitForReady(volatile bool *abort);
+	void cancel(void);
+
+protected:
+	const QString m_sourceFile;
+	const QString m_stagedFile;
+	const qint64 m_size;
+
+	QMutex m_mutex;
+	QWaitCondition m_stateChanged;
+	state_t m_state;
+};
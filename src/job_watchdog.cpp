@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "job_watchdog.h"
+
+#include "global.h"
+#include "model_status.h"
+#include "job_object.h"
+
+#include <QFileInfo>
+
+JobWatchdog::JobWatchdog(JobObject *const jobObject, const QStringList &outputFiles, const unsigned int &interval, const unsigned int &warningCount, const unsigned int &stalledCount)
+:
+	m_jobObject(jobObject),
+	m_outputFiles(outputFiles),
+	m_interval(interval),
+	m_warningCount(warningCount),
+	m_stalledCount(stalledCount)
+{
+	reset();
+}
+
+void JobWatchdog::reset(void)
+{
+	m_counter = 0;
+	m_initialized = false;
+	m_cpuTime = m_readBytes = 0;
+	m_outputSize = 0;
+	m_progress = 0.0;
+	m_timer.start();
+}
+
+void JobWatchdog::addLine(const QString &line)
+{
+	if(!line.isEmpty())
+	{
+		m_lines.enqueue(line);
+		while(m_lines.count() > MAX_LINES)
+		{
+			m_lines.dequeue();
+		}
+	}
+}
+
+JobWatchdog::status_t JobWatchdog::check(const double &progress)
+{
+	if(m_timer.elapsed() < qint64(m_interval))
+	{
+		return WATCHDOG_ALIVE;
+	}
+
+	m_timer.start();
+
+	if(update(progress))
+	{
+		m_counter = 0;
+		return WATCHDOG_ALIVE;
+	}
+
+	if(++m_counter > m_stalledCount)
+	{
+		return WATCHDOG_STALLED;
+	}
+
+	return (m_counter == m_warningCount) ? WATCHDOG_WARNING : WATCHDOG_ALIVE;
+}
+
+unsigned int JobWatchdog::getStalledTime(void) const
+{
+	return (m_counter * m_interval) / 1000U;
+}
+
+QStringList JobWatchdog::getDiagnostics(void) const
+{
+	QStringList diagnostics;
+
+	diagnostics << QString("Stalled for %1 seconds: No CPU time consumed, no input read, no output written and no progress reported.").arg(QString::number(getStalledTime()));
+	diagnostics << QString("CPU time: %1 msec, input: %2 bytes, output: %3 bytes, progress: %4%").arg(QString::number(m_cpuTime), QString::number(m_readBytes), QString::number(m_outputSize), QString::number(m_progress * 100.0, 'f', 1));
+
+	QStringList processInfo;
+	if(m_jobObject && m_jobObject->getProcessInfo(processInfo))
+	{
+		diagnostics << QString("\nProcesses:");
+		diagnostics << processInfo;
+	}
+
+	if(!m_lines.isEmpty())
+	{
+		diagnostics << QString("\nLast output:");
+		diagnostics << m_lines;
+	}
+
+	return diagnostics;
+}
+
+bool JobWatchdog::update(const double &progress)
+{
+	bool advanced = (!m_initialized);
+
+	JobStatistics stats;
+	if(m_jobObject && m_jobObject->queryStatistics(stats))
+	{
+		//Ignore the little CPU time needed for just printing status lines
+		const quint64 cpuTime = stats.userTime + stats.kernelTime;
+		if(cpuTime >= m_cpuTime + (m_interval / 20U))
+		{
+			advanced = true;
+		}
+		m_cpuTime = cpuTime;
+		if(stats.readBytes > m_readBytes)
+		{
+			m_readBytes = stats.readBytes;
+			advanced = true;
+		}
+	}
+
+	const qint64 outputSize = getOutputSize();
+	if(outputSize > m_outputSize)
+	{
+		m_outputSize = outputSize;
+		advanced = true;
+	}
+
+	if(progress > m_progress)
+	{
+		m_progress = progress;
+		advanced = true;
+	}
+
+	m_initialized = true;
+	return advanced;
+}
+
+qint64 JobWatchdog::getOutputSize(void) const
+{
+	qint64 outputSize = 0;
+	for(QStringList::ConstIterator iter = m_outputFiles.constBegin(); iter != m_outputFiles.constEnd(); iter++)
+	{
+		if(!iter->isEmpty())
+		{
+			QFileInfo fileInfo(*iter);
+			if(fileInfo.exists() && fileInfo.isFile())
+			{
+				outputSize += fileInfo.size();
+			}
+		}
+	}
+	return outputSize;
+}
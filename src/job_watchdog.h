@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QQueue>
+#include <QElapsedTimer>
+
+class JobObject;
+
+class JobWatchdog
+{
+public:
+	typedef enum
+	{
+		WATCHDOG_ALIVE   = 0,
+		WATCHDOG_WARNING = 1,
+		WATCHDOG_STALLED = 2
+	}
+	status_t;
+
+	JobWatchdog(JobObject *const jobObject, const QStringList &outputFiles, const unsigned int &interval, const unsigned int &warningCount, const unsigned int &stalledCount);
+
+	void reset(void);
+	void addLine(const QString &line);
+	status_t check(const double &progress);
+
+	unsigned int getStalledTime(void) const;
+	QStringList getDiagnostics(void) const;
+
+protected:
+	static const int MAX_LINES = 16;
+
+	bool update(const double &progress);
+	qint64 getOutputSize(void) const;
+
+	JobObject *const m_jobObject;
+	const QStringList m_outputFiles;
+	const unsigned int m_interval;
+	const unsigned int m_warningCount;
+	const unsigned int m_stalledCount;
+
+	QElapsedTimer m_timer;
+	unsigned int m_counter;
+	bool m_initialized;
+
+	quint64 m_cpuTime;
+	quint64 m_readBytes;
+	qint64 m_outputSize;
+	double m_progress;
+
+	QQueue<QString> m_lines;
+};
@@ -25,6 +25,7 @@
 #include "cli.h"
 #include "ipc.h"
 #include "thread_ipc_send.h"
+#include "benchmark.h"
 
 //MUtils
 #include <MUtils/Startup.h>
@@ -165,6 +166,12 @@ static int simple_x264_main(int &argc, char **argv)
 		return (iResult == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 	}
 
+	//Run the benchmarks instead of the GUI, if requested
+	if(arguments.contains(CLI_PARAM_BENCHMARK))
+	{
+		return Benchmark::run(arguments.values(CLI_PARAM_BENCHMARK));
+	}
+
 	//Running in portable mode?
 	if(x264_is_portable())
 	{
@@ -26,6 +26,13 @@
 #include "encoder_factory.h"
 #include "model_options.h"
 #include "model_preferences.h"
+#include "job_spool.h"
+#include "job_render.h"
+#include "thread_render.h"
+#include "job_stage.h"
+#include "thread_stage.h"
+#include "thread_log.h"
+#include "model_logIndex.h"
 #include "resource.h"
 
 //MUtils
@@ -34,32 +41,122 @@
 //Qt
 #include <QIcon>
 #include <QFileInfo>
+#include <QDir>
 #include <QSettings>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QTimer>
+#include <QElapsedTimer>
+
+//CRT
+#include <algorithm>
 
 static const char *KEY_ENTRY_COUNT = "entry_count";
 static const char *KEY_SOURCE_FILE = "source_file";
 static const char *KEY_OUTPUT_FILE = "output_file";
 static const char *KEY_ENC_OPTIONS = "enc_options";
+static const char *KEY_INTERACTIVE = "interactive";
+static const char *KEY_IO_PRIORITY = "io_priority";
+static const char *KEY_IO_LIMIT    = "io_bandwidth_limit";
+static const char *KEY_JOB_NAME    = "job_name";
+static const char *KEY_JOB_STATUS  = "job_status";
+static const char *KEY_FINISHED_AT = "finished_at";
+static const char *KEY_USER_TIME   = "cpu_time_user";
+static const char *KEY_KERNEL_TIME = "cpu_time_kernel";
+static const char *KEY_PEAK_MEMORY = "peak_memory_resident";
+static const char *KEY_PEAK_COMMIT = "peak_memory_committed";
+static const char *KEY_READ_BYTES  = "io_read_bytes";
+static const char *KEY_WRITE_BYTES = "io_write_bytes";
+static const char *KEY_READ_OPS    = "io_read_operations";
+static const char *KEY_WRITE_OPS   = "io_write_operations";
+static const char *KEY_PROCESSES   = "process_count";
 
 static const char *JOB_TEMPLATE = "job_%08x";
 
+//Finished jobs are checked for archiving this often
+static const int ARCHIVE_INTERVAL = 60000;
+
+//Resource usage of running jobs is sampled this often
+static const int SAMPLE_INTERVAL = 1000;
+
+//The statistics log is rotated once it exceeds this size (only one old generation is kept)
+static const qint64 MAX_STATISTICS_SIZE = 4 * 1024 * 1024;
+
 #define VALID_INDEX(INDEX) ((INDEX).isValid() && ((INDEX).row() >= 0) && ((INDEX).row() < m_jobs.count()))
 
-JobListModel::JobListModel(PreferencesModel *preferences)
+JobListModel::JobListModel(PreferencesModel *preferences, const SysinfoModel *sysinfo)
+:
+	m_recoveryTimer(NULL),
+	m_renderThread(NULL),
+	m_stageThread(NULL),
+	m_logIndex(new LogIndex()),
+	m_sysinfo(sysinfo)
 {
 	m_preferences = preferences;
+
+	//Archives are only valid for the current session, remove leftovers
+	const QDir archiveDir(QString("%1/archive").arg(x264_data_path()));
+	if(archiveDir.exists())
+	{
+		const QFileInfoList files = archiveDir.entryInfoList(QStringList() << "*.ini", QDir::Files);
+		for(QFileInfoList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+		{
+			QFile::remove(iter->absoluteFilePath());
+		}
+	}
+
+	m_archiveTimer = new QTimer(this);
+	connect(m_archiveTimer, SIGNAL(timeout()), this, SLOT(archiveJobs()));
+	m_archiveTimer->start(ARCHIVE_INTERVAL);
+
+	m_sampleTimer = new QTimer(this);
+	connect(m_sampleTimer, SIGNAL(timeout()), this, SLOT(sampleResourceUsage()));
 }
 
 JobListModel::~JobListModel(void)
 {
-	while(!m_jobs.isEmpty())
+	if(m_renderThread)
 	{
-		QUuid id = m_jobs.takeFirst();
-		EncodeThread *thread = m_threads.value(id, NULL);
-		LogFileModel *logFile = m_logFile.value(id, NULL);
-		MUTILS_DELETE(thread);
-		MUTILS_DELETE(logFile);
+		m_renderThread->stop();
+		if(!m_renderThread->wait(5000))
+		{
+			m_renderThread->terminate();
+			m_renderThread->wait();
+		}
+		MUTILS_DELETE(m_renderThread);
 	}
+
+	if(m_stageThread)
+	{
+		m_stageThread->stop();
+		if(!m_stageThread->wait(5000))
+		{
+			m_stageThread->terminate();
+			m_stageThread->wait();
+		}
+		MUTILS_DELETE(m_stageThread);
+	}
+
+	for(QVector<job_t>::Iterator job = m_jobs.begin(); job != m_jobs.end(); job++)
+	{
+		MUTILS_DELETE(job->thread);
+		MUTILS_DELETE(job->logFile);
+		if(job->spooled && (!job->recovered))
+		{
+			JobSpool(job->id).remove();
+		}
+		MUTILS_DELETE(job->recovered);
+		if(isArchived(*job))
+		{
+			QFile::remove(getArchiveFile(job->id));
+		}
+		job->descriptor.releaseLookAhead(true);
+	}
+	m_jobs.clear();
+
+	MUTILS_DELETE(m_logIndex);
+	LogWriter::shutdown();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -122,10 +219,10 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
 			switch(index.column())
 			{
 			case 0:
-				return m_name.value(m_jobs.at(index.row()));
+				return m_jobs.at(index.row()).name;
 				break;
 			case 1:
-				switch(m_status.value(m_jobs.at(index.row())))
+				switch(m_jobs.at(index.row()).status)
 				{
 				case JobStatus_Enqueued:
 					return QVariant::fromValue<QString>(tr("Enqueued."));
@@ -166,16 +263,19 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
 				case JobStatus_Aborted:
 					return QVariant::fromValue<QString>(tr("Aborted!"));
 					break;
+				case JobStatus_Finalizing:
+					return QVariant::fromValue<QString>(tr("Copying output..."));
+					break;
 				default:
 					return QVariant::fromValue<QString>(tr("(Unknown)"));
 					break;
 				}
 				break;
 			case 2:
-				return QString().sprintf("%d%%", m_progress.value(m_jobs.at(index.row())));
+				return QString().sprintf("%d%%", m_jobs.at(index.row()).progress);
 				break;
 			case 3:
-				return m_details.value(m_jobs.at(index.row()));
+				return m_jobs.at(index.row()).details;
 				break;
 			default:
 				return QVariant();
@@ -183,11 +283,37 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
 			}
 		}
 	}
+	else if(role == Qt::ToolTipRole)
+	{
+		if(index.row() >= 0 && index.row() < m_jobs.count() && index.column() == 3)
+		{
+			const job_t &job = m_jobs.at(index.row());
+			if(job.hasStatistics)
+			{
+				const JobStatistics &stats = job.statistics;
+				QStringList lines;
+				lines << tr("CPU Time: %1 s (User), %2 s (Kernel)").arg(QString::number(double(stats.userTime) / 1000.0, 'f', 1), QString::number(double(stats.kernelTime) / 1000.0, 'f', 1));
+				lines << tr("Memory: %1 (Peak Resident), %2 (Peak Committed)").arg(AbstractEncoder::sizeToString(stats.peakWorkingSet), AbstractEncoder::sizeToString(stats.peakCommitted));
+				lines << tr("I/O: %1 read, %2 written").arg(AbstractEncoder::sizeToString(stats.readBytes), AbstractEncoder::sizeToString(stats.writeBytes));
+				lines << tr("Processes: %1").arg(QString::number(stats.processCount));
+				if(!job.volume.isEmpty())
+				{
+					lines << tr("Output Volume: %1").arg(QDir::toNativeSeparators(job.volume));
+				}
+				return lines.join("\n");
+			}
+			if(!job.volume.isEmpty())
+			{
+				return QString("%1\n%2").arg(job.details, tr("Output Volume: %1").arg(QDir::toNativeSeparators(job.volume)));
+			}
+			return job.details;
+		}
+	}
 	else if(role == Qt::DecorationRole)
 	{
 		if(index.row() >= 0 && index.row() < m_jobs.count() && index.column() == 0)
 		{
-			switch(m_status.value(m_jobs.at(index.row())))
+			switch(m_jobs.at(index.row()).status)
 			{
 			case JobStatus_Enqueued:
 				return QIcon(":/buttons/hourglass.png");
@@ -224,6 +350,9 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
 			case JobStatus_Aborted:
 				return QIcon(":/buttons/error.png");
 				break;
+			case JobStatus_Finalizing:
+				return QIcon(":/buttons/disk.png");
+				break;
 			default:
 				return QVariant();
 				break;
@@ -238,66 +367,53 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
 // Public interface
 ///////////////////////////////////////////////////////////////////////////////
 
-QModelIndex JobListModel::insertJob(EncodeThread *thread)
+QModelIndex JobListModel::insertJob(const JobDescriptor &job, const bool &deferLookAhead)
 {
-	const QUuid id = thread->getId();
-	if(m_jobs.contains(id))
+	const QUuid id = job.getId();
+	if((!job.isValid()) || (!job.options()) || m_rows.contains(id))
 	{
 		return QModelIndex();
 	}
 	
-	const AbstractEncoderInfo &encoderInfo = EncoderFactory::getEncoderInfo(thread->options()->encType());
+	const AbstractEncoderInfo &encoderInfo = EncoderFactory::getEncoderInfo(job.options()->encType());
 	const QStringList encoderNameParts = encoderInfo.getName().simplified().split(' ', QString::SkipEmptyParts);
 	QString config = encoderNameParts.isEmpty() ? encoderInfo.getName() : encoderNameParts.first();
-	switch(encoderInfo.rcModeToType(thread->options()->rcMode()))
+	switch(encoderInfo.rcModeToType(job.options()->rcMode()))
 	{
 	case AbstractEncoderInfo::RC_TYPE_QUANTIZER:
-		config.append(QString(", %1@%2").arg(encoderInfo.rcModeToString(thread->options()->rcMode()), QString::number(qRound(thread->options()->quantizer()))));
+		config.append(QString(", %1@%2").arg(encoderInfo.rcModeToString(job.options()->rcMode()), QString::number(qRound(job.options()->quantizer()))));
 		break;
 	case AbstractEncoderInfo::RC_TYPE_RATE_KBPS:
 	case AbstractEncoderInfo::RC_TYPE_MULTIPASS:
-		config.append(QString(", %1@%2").arg(encoderInfo.rcModeToString(thread->options()->rcMode()), QString::number(thread->options()->bitrate())));
+		config.append(QString(", %1@%2").arg(encoderInfo.rcModeToString(job.options()->rcMode()), QString::number(job.options()->bitrate())));
 		break;
 	}
 
 	int n = 2;
-	QString jobName = QString("%1 [%2]").arg(QFileInfo(thread->sourceFileName()).completeBaseName().simplified(), config);
-	forever
+	const QString baseName = QFileInfo(job.sourceFileName()).completeBaseName().simplified();
+	QString jobName = QString("%1 [%2]").arg(baseName, config);
+	while(m_names.contains(jobName.toLower()))
 	{
-		bool unique = true;
-		for(int i = 0; i < m_jobs.count(); i++)
-		{
-			if(m_name.value(m_jobs.at(i)).compare(jobName, Qt::CaseInsensitive) == 0)
-			{
-				unique = false;
-				break;
-			}
-		}
-		if(!unique)
-		{
-			jobName = QString("%1 %2 [%3]").arg(QFileInfo(thread->sourceFileName()).completeBaseName().simplified(), QString::number(n++), config);
-			continue;
-		}
-		break;
+		jobName = QString("%1 %2 [%3]").arg(baseName, QString::number(n++), config);
 	}
 	
-	LogFileModel *logFile = new LogFileModel(thread->sourceFileName(), thread->outputFileName(), config);
+	job_t record;
+	record.id = id;
+	record.name = jobName;
+	record.details = tr("Not started yet.");
+	record.config = config;
+	record.descriptor = job;
 	
 	beginInsertRows(QModelIndex(), m_jobs.count(), m_jobs.count());
-	m_jobs.append(id);
-	m_name.insert(id, jobName);
-	m_status.insert(id, JobStatus_Enqueued);
-	m_progress.insert(id, 0);
-	m_threads.insert(id, thread);
-	m_logFile.insert(id, logFile);
-	m_details.insert(id, tr("Not started yet."));
+	m_rows.insert(id, m_jobs.count());
+	m_jobs.append(record);
+	addName(jobName);
 	endInsertRows();
 
-	connect(thread, SIGNAL(statusChanged(QUuid, JobStatus)), this, SLOT(updateStatus(QUuid, JobStatus)), Qt::QueuedConnection);
-	connect(thread, SIGNAL(progressChanged(QUuid, unsigned int)), this, SLOT(updateProgress(QUuid, unsigned int)), Qt::QueuedConnection);
-	connect(thread, SIGNAL(messageLogged(QUuid, qint64, QString)), logFile, SLOT(addLogMessage(QUuid, qint64,  QString)), Qt::QueuedConnection);
-	connect(thread, SIGNAL(detailsChanged(QUuid, QString)), this, SLOT(updateDetails(QUuid, QString)), Qt::QueuedConnection);
-	
+	if(!deferLookAhead)
+	{
+		updateLookAhead();
+	}
 	return createIndex(m_jobs.count() - 1, 0, NULL);
 }
 
@@ -305,12 +421,32 @@ bool JobListModel::startJob(const QModelIndex &index)
 {
 	if(VALID_INDEX(index))
 	{
-		QUuid id = m_jobs.at(index.row());
-		if(m_status.value(id) == JobStatus_Enqueued)
+		const job_t &pending = m_jobs.at(index.row());
+		if((pending.status == JobStatus_Enqueued) && pending.descriptor.isValid() && (!pending.thread))
 		{
+			const QUuid id = pending.id;
 			updateStatus(id, JobStatus_Starting);
 			updateDetails(id, tr("Starting up, please wait..."));
-			m_threads.value(id)->start();
+			job_t &job = m_jobs[index.row()];
+
+			//The thread, with its job object and encoder, only exists while the job is actually running
+			EncodeThread *thread = new EncodeThread(job.descriptor, m_sysinfo, m_preferences);
+			connect(thread, SIGNAL(statusChanged(QUuid, JobStatus)), this, SLOT(updateStatus(QUuid, JobStatus)), Qt::QueuedConnection);
+			connect(thread, SIGNAL(progressChanged(QUuid, unsigned int)), this, SLOT(updateProgress(QUuid, unsigned int)), Qt::QueuedConnection);
+			connect(thread, SIGNAL(messageLogged(QUuid, qint64, qint64, QString)), createLogFile(job), SLOT(addLogMessage(QUuid, qint64, qint64, QString)), Qt::QueuedConnection);
+			connect(thread, SIGNAL(detailsChanged(QUuid, QString)), this, SLOT(updateDetails(QUuid, QString)), Qt::QueuedConnection);
+			connect(thread, SIGNAL(statisticsChanged(QUuid, JobStatistics)), this, SLOT(updateStatistics(QUuid, JobStatistics)), Qt::QueuedConnection);
+			connect(thread, SIGNAL(outputPlaced(QUuid, QString)), this, SLOT(updateOutputFile(QUuid, QString)), Qt::QueuedConnection);
+			connect(thread, SIGNAL(finished()), this, SLOT(threadFinished()), Qt::QueuedConnection);
+			job.thread = thread;
+
+			updateIoClasses();
+			thread->start();
+			updateLookAhead();
+			if(!m_sampleTimer->isActive())
+			{
+				m_sampleTimer->start(SAMPLE_INTERVAL);
+			}
 			return true;
 		}
 	}
@@ -322,14 +458,17 @@ bool JobListModel::pauseJob(const QModelIndex &index)
 {
 	if(VALID_INDEX(index))
 	{
-		QUuid id = m_jobs.at(index.row());
-		JobStatus status = m_status.value(id);
+		const job_t &job = m_jobs.at(index.row());
+		JobStatus status = job.status;
 		if((status == JobStatus_Indexing) || (status == JobStatus_Running) ||
 			(status == JobStatus_Running_Pass1) || (status == JobStatus_Running_Pass2))
 		{
-			updateStatus(id, JobStatus_Pausing);
-			m_threads.value(id)->pauseJob();
-			return true;
+			if(EncodeThread *thread = job.thread)
+			{
+				updateStatus(job.id, JobStatus_Pausing);
+				thread->pauseJob();
+				return true;
+			}
 		}
 	}
 
@@ -340,13 +479,16 @@ bool JobListModel::resumeJob(const QModelIndex &index)
 {
 	if(VALID_INDEX(index))
 	{
-		QUuid id = m_jobs.at(index.row());
-		JobStatus status = m_status.value(id);
+		const job_t &job = m_jobs.at(index.row());
+		JobStatus status = job.status;
 		if(status == JobStatus_Paused)
 		{
-			updateStatus(id, JobStatus_Resuming);
-			m_threads.value(id)->resumeJob();
-			return true;
+			if(EncodeThread *thread = job.thread)
+			{
+				updateStatus(job.id, JobStatus_Resuming);
+				thread->resumeJob();
+				return true;
+			}
 		}
 	}
 
@@ -357,13 +499,22 @@ bool JobListModel::abortJob(const QModelIndex &index)
 {
 	if(VALID_INDEX(index))
 	{
-		QUuid id = m_jobs.at(index.row());
-		if(m_status.value(id) == JobStatus_Indexing || m_status.value(id) == JobStatus_Running ||
-			m_status.value(id) == JobStatus_Running_Pass1 || JobStatus_Running_Pass2)
+		const job_t &job = m_jobs.at(index.row());
+		if(job.status == JobStatus_Indexing || job.status == JobStatus_Running ||
+			job.status == JobStatus_Running_Pass1 || JobStatus_Running_Pass2)
 		{
-			updateStatus(id, JobStatus_Aborting);
-			m_threads.value(id)->abortJob();
-			return true;
+			if(EncodeThread *thread = job.thread)
+			{
+				updateStatus(job.id, JobStatus_Aborting);
+				thread->abortJob();
+				return true;
+			}
+			if(JobSpool *spool = job.recovered)
+			{
+				updateStatus(job.id, JobStatus_Aborting);
+				spool->terminate();
+				return true;
+			}
 		}
 	}
 
@@ -374,28 +525,35 @@ bool JobListModel::deleteJob(const QModelIndex &index)
 {
 	if(VALID_INDEX(index))
 	{
-		QUuid id = m_jobs.at(index.row());
-		if(m_status.value(id) == JobStatus_Completed || m_status.value(id) == JobStatus_Failed ||
-			m_status.value(id) == JobStatus_Aborted || m_status.value(id) == JobStatus_Enqueued)
+		const int idx = index.row();
+		job_t &job = m_jobs[idx];
+		if(job.status == JobStatus_Completed || job.status == JobStatus_Failed ||
+			job.status == JobStatus_Aborted || job.status == JobStatus_Enqueued)
 		{
-			int idx = index.row();
-			QUuid id = m_jobs.at(idx);
-			EncodeThread *thread = m_threads.value(id, NULL);
-			LogFileModel *logFile = m_logFile.value(id, NULL);
-			if((thread == NULL) || (!thread->isRunning()))
+			if(!job.thread)
 			{
-				
+				const QUuid id = job.id;
+				LogFileModel *logFile = job.logFile;
+				if(isArchived(job))
+				{
+					QFile::remove(getArchiveFile(id));
+				}
+				if(job.spooled)
+				{
+					JobSpool(id).remove();
+				}
+				job.descriptor.releaseLookAhead(true);
+
 				beginRemoveRows(QModelIndex(), idx, idx);
-				m_jobs.removeAt(index.row());
-				m_name.remove(id);
-				m_threads.remove(id);
-				m_status.remove(id);
-				m_progress.remove(id);
-				m_logFile.remove(id);
-				m_details.remove(id);
+				removeName(job.name);
+				m_rows.remove(id);
+				m_jobs.remove(idx);
+				updateRows(idx, m_jobs.count() - 1);
 				endRemoveRows();
-				MUTILS_DELETE(thread);
 				MUTILS_DELETE(logFile);
+				m_logIndex->removeJob(id);
+				LogWriter::remove(id);
+				updateLookAhead();
 				return true;
 			}
 		}
@@ -411,14 +569,16 @@ bool JobListModel::moveJob(const QModelIndex &index, const int &direction)
 		if((direction == MOVE_UP) && (index.row() > 0))
 		{
 			beginMoveRows(QModelIndex(), index.row(), index.row(), QModelIndex(), index.row() - 1);
-			m_jobs.swap(index.row(), index.row() - 1);
+			qSwap(m_jobs[index.row()], m_jobs[index.row() - 1]);
+			updateRows(index.row() - 1, index.row());
 			endMoveRows();
 			return true;
 		}
 		if((direction == MOVE_DOWN) && (index.row() < m_jobs.size() - 1))
 		{
 			beginMoveRows(QModelIndex(), index.row(), index.row(), QModelIndex(), index.row() + 2);
-			m_jobs.swap(index.row(), index.row() + 1);
+			qSwap(m_jobs[index.row()], m_jobs[index.row() + 1]);
+			updateRows(index.row(), index.row() + 1);
 			endMoveRows();
 			return true;
 		}
@@ -431,20 +591,25 @@ LogFileModel *JobListModel::getLogFile(const QModelIndex &index)
 {
 	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
 	{
-		return m_logFile.value(m_jobs.at(index.row()));
+		return createLogFile(m_jobs[index.row()]);
 	}
 
 	return NULL;
 }
 
+const LogIndex *JobListModel::getLogIndex(void) const
+{
+	return m_logIndex;
+}
+
 const QString &JobListModel::getJobSourceFile(const QModelIndex &index)
 {
 	static QString nullStr;
 	
 	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
 	{
-		EncodeThread *thread = m_threads.value(m_jobs.at(index.row()));
-		return (thread != NULL) ? thread->sourceFileName() : nullStr;
+		const job_t &job = m_jobs.at(index.row());
+		return job.descriptor.isValid() ? job.descriptor.sourceFileName() : nullStr;
 	}
 
 	return nullStr;
@@ -456,8 +621,8 @@ const QString &JobListModel::getJobOutputFile(const QModelIndex &index)
 	
 	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
 	{
-		EncodeThread *thread = m_threads.value(m_jobs.at(index.row()));
-		return (thread != NULL) ? thread->outputFileName() : nullStr;
+		const job_t &job = m_jobs.at(index.row());
+		return job.descriptor.isValid() ? job.descriptor.outputFileName() : nullStr;
 	}
 
 	return nullStr;
@@ -467,7 +632,7 @@ JobStatus JobListModel::getJobStatus(const QModelIndex &index)
 {
 	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
 	{
-		return m_status.value(m_jobs.at(index.row()));
+		return m_jobs.at(index.row()).status;
 	}
 
 	return static_cast<JobStatus>(-1);
@@ -477,7 +642,7 @@ unsigned int JobListModel::getJobProgress(const QModelIndex &index)
 {
 	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
 	{
-		return m_progress.value(m_jobs.at(index.row()));
+		return m_jobs.at(index.row()).progress;
 	}
 
 	return 0;
@@ -489,8 +654,27 @@ const OptionsModel *JobListModel::getJobOptions(const QModelIndex &index)
 	
 	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
 	{
-		EncodeThread *thread = m_threads.value(m_jobs.at(index.row()));
-		return (thread != NULL) ? thread->options() : NULL;
+		const job_t &job = m_jobs.at(index.row());
+		if(job.descriptor.options())
+		{
+			return job.descriptor.options();
+		}
+		if(isArchived(job))
+		{
+			//Options of archived jobs are loaded on demand, only the most recent ones are kept
+			if(m_archivedOptions.isNull() || (m_archivedOptionsId != job.id))
+			{
+				m_archivedOptions.reset(new OptionsModel(m_sysinfo));
+				m_archivedOptionsId = job.id;
+				QSettings settings(getArchiveFile(job.id), QSettings::IniFormat);
+				settings.beginGroup(KEY_ENC_OPTIONS);
+				if(!OptionsModel::loadOptions(m_archivedOptions.data(), settings))
+				{
+					m_archivedOptions.reset();
+				}
+			}
+			return m_archivedOptions.data();
+		}
 	}
 
 	return NULL;
@@ -498,14 +682,91 @@ const OptionsModel *JobListModel::getJobOptions(const QModelIndex &index)
 
 QModelIndex JobListModel::getJobIndexById(const QUuid &id)
 {
-	if(m_jobs.contains(id))
+	const int row = getRow(id);
+	if(row >= 0)
 	{
-		return createIndex(m_jobs.indexOf(id), 0);
+		return createIndex(row, 0);
 	}
 
 	return QModelIndex();
 }
 
+bool JobListModel::getJobInteractive(const QModelIndex &index)
+{
+	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
+	{
+		return m_jobs.at(index.row()).descriptor.isInteractive();
+	}
+
+	return false;
+}
+
+bool JobListModel::setJobInteractive(const QModelIndex &index, const bool &interactive)
+{
+	if(VALID_INDEX(index))
+	{
+		job_t &job = m_jobs[index.row()];
+		if(job.descriptor.isValid())
+		{
+			job.descriptor.setInteractive(interactive);
+			if(EncodeThread *thread = job.thread)
+			{
+				thread->setInteractive(interactive);
+			}
+			updateIoClasses();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool JobListModel::getJobIoClass(const QModelIndex &index, int &ioPriority, int &ioBandwidthLimit)
+{
+	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
+	{
+		const JobDescriptor &job = m_jobs.at(index.row()).descriptor;
+		if(job.isValid())
+		{
+			ioPriority = job.getIoPriority();
+			ioBandwidthLimit = job.getIoBandwidthLimit();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool JobListModel::setJobIoClass(const QModelIndex &index, const int &ioPriority, const int &ioBandwidthLimit)
+{
+	if(VALID_INDEX(index))
+	{
+		job_t &job = m_jobs[index.row()];
+		if(job.descriptor.isValid())
+		{
+			job.descriptor.setIoClass(ioPriority, ioBandwidthLimit);
+			updateIoClasses();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const JobStatistics *JobListModel::getJobStatistics(const QModelIndex &index)
+{
+	if(index.isValid() && index.row() >= 0 && index.row() < m_jobs.count())
+	{
+		const job_t &job = m_jobs.at(index.row());
+		if(job.hasStatistics)
+		{
+			return &job.statistics;
+		}
+	}
+
+	return NULL;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Slots
 ///////////////////////////////////////////////////////////////////////////////
@@ -514,11 +775,31 @@ void JobListModel::updateStatus(const QUuid &jobId, JobStatus newStatus)
 {
 	int index = -1;
 	
-	if((index = m_jobs.indexOf(jobId)) >= 0)
+	if((index = getRow(jobId)) >= 0)
 	{
-		m_status.insert(jobId, newStatus);
+		m_jobs[index].status = newStatus;
 		emit dataChanged(createIndex(index, 0), createIndex(index, 1));
 
+		if(m_jobs.at(index).descriptor.isInteractive())
+		{
+			updateIoClasses();
+		}
+
+		if((newStatus == JobStatus_Completed) || (newStatus == JobStatus_Failed) || (newStatus == JobStatus_Aborted))
+		{
+			if(m_jobs.at(index).hasStatistics)
+			{
+				saveStatistics(m_jobs.at(index));
+			}
+			m_jobs[index].finishedAt = QDateTime::currentMSecsSinceEpoch();
+			if(LogFileModel *const logFile = m_jobs.at(index).logFile)
+			{
+				logFile->squeeze();
+			}
+			updateLookAhead();
+			QTimer::singleShot(0, this, SLOT(archiveJobs()));
+		}
+
 		if(m_preferences->getEnableSounds())
 		{
 			switch(newStatus)
@@ -541,9 +822,9 @@ void JobListModel::updateProgress(const QUuid &jobId, unsigned int newProgress)
 {
 	int index = -1;
 
-	if((index = m_jobs.indexOf(jobId)) >= 0)
+	if((index = getRow(jobId)) >= 0)
 	{
-		m_progress.insert(jobId, qBound(0U, newProgress, 100U));
+		m_jobs[index].progress = qBound(0U, newProgress, 100U);
 		emit dataChanged(createIndex(index, 2), createIndex(index, 2));
 	}
 }
@@ -552,13 +833,348 @@ void JobListModel::updateDetails(const QUuid &jobId, const QString &details)
 {
 	int index = -1;
 
-	if((index = m_jobs.indexOf(jobId)) >= 0)
+	if((index = getRow(jobId)) >= 0)
 	{
-		m_details.insert(jobId, details);
+		m_jobs[index].details = details;
 		emit dataChanged(createIndex(index, 3), createIndex(index, 3));
 	}
 }
 
+void JobListModel::updateStatistics(const QUuid &jobId, const JobStatistics &statistics)
+{
+	int index = -1;
+
+	if((index = getRow(jobId)) >= 0)
+	{
+		m_jobs[index].statistics = statistics;
+		m_jobs[index].hasStatistics = true;
+		emit dataChanged(createIndex(index, 3), createIndex(index, 3));
+	}
+}
+
+void JobListModel::updateOutputFile(const QUuid &jobId, const QString &outputFile)
+{
+	int index = -1;
+
+	if((index = getRow(jobId)) >= 0)
+	{
+		m_jobs[index].descriptor.setOutputFileName(outputFile);
+		m_jobs[index].volume = QFileInfo(outputFile).absolutePath();
+		emit dataChanged(createIndex(index, 0), createIndex(index, 3));
+	}
+}
+
+void JobListModel::updateIoClasses(void)
+{
+	bool interactiveJobActive = false;
+	for(QVector<job_t>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
+	{
+		const JobStatus status = iter->status;
+		if((status != JobStatus_Enqueued) && (status != JobStatus_Completed) && (status != JobStatus_Failed) && (status != JobStatus_Aborted) && (status != JobStatus_Paused))
+		{
+			if(iter->descriptor.isInteractive())
+			{
+				interactiveJobActive = true;
+				break;
+			}
+		}
+	}
+
+	//Interactive jobs are never throttled, bulk jobs yield to them
+	for(QVector<job_t>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
+	{
+		if(EncodeThread *const thread = iter->thread)
+		{
+			const JobDescriptor &job = iter->descriptor;
+			if(job.isInteractive())
+			{
+				thread->setIoClass(0, 0);
+			}
+			else
+			{
+				const int ioPriority = (job.getIoPriority() != JobDescriptor::IO_PRIORITY_DEFAULT) ? job.getIoPriority() : m_preferences->getIoPriority();
+				const unsigned int ioBandwidthLimit = (job.getIoBandwidthLimit() != JobDescriptor::IO_BANDWIDTH_DEFAULT) ? static_cast<unsigned int>(job.getIoBandwidthLimit()) : m_preferences->getIoBandwidthLimit();
+				thread->setIoClass(interactiveJobActive ? -2 : ioPriority, ioBandwidthLimit);
+			}
+		}
+	}
+}
+
+void JobListModel::updateLookAhead(void)
+{
+	updateRenderAhead();
+	updateInputStaging();
+}
+
+void JobListModel::updateRenderAhead(void)
+{
+	const unsigned int lookAhead = m_preferences->getRenderAheadJobs();
+	if(lookAhead < 1)
+	{
+		return;
+	}
+
+	if(!m_renderThread)
+	{
+		m_renderThread = new RenderThread();
+		m_renderThread->start(QThread::LowPriority);
+	}
+
+	//The spool budget is shared by all jobs that are rendered ahead, running jobs keep their spool until they have finished
+	const qint64 budget = qint64(m_preferences->getRenderAheadSpool()) << 20;
+	qint64 usedSpace = 0;
+	unsigned int count = 0, missing = 0;
+	for(QVector<job_t>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
+	{
+		const QSharedPointer<RenderSpool> &spool = iter->descriptor.getRenderSpool();
+		if(!spool.isNull())
+		{
+			usedSpace += spool->getCapacity();
+		}
+		if((iter->status == JobStatus_Enqueued) && iter->descriptor.isValid() && (count < lookAhead))
+		{
+			if(spool.isNull()) missing++;
+			count++;
+		}
+	}
+
+	if((missing < 1) || (usedSpace >= budget))
+	{
+		return;
+	}
+
+	const qint64 capacity = (budget - usedSpace) / qint64(missing);
+	if(capacity < Q_INT64_C(1048576))
+	{
+		return; /*not enough space left for another spool*/
+	}
+
+	count = 0;
+
+	for(QVector<job_t>::Iterator iter = m_jobs.begin(); (iter != m_jobs.end()) && (count < lookAhead); iter++)
+	{
+		if((iter->status == JobStatus_Enqueued) && iter->descriptor.isValid())
+		{
+			if(!iter->descriptor.getRenderSpool().isNull())
+			{
+				count++;
+				continue;
+			}
+			const QSharedPointer<RenderSpool> spool = iter->descriptor.createRenderSpool(m_sysinfo, m_preferences, capacity);
+			if(!spool.isNull())
+			{
+				m_renderThread->enqueue(spool);
+				count++;
+			}
+		}
+	}
+}
+
+void JobListModel::updateInputStaging(void)
+{
+	const unsigned int lookAhead = m_preferences->getStageInputJobs();
+	if(lookAhead < 1)
+	{
+		return;
+	}
+
+	if(!m_stageThread)
+	{
+		m_stageThread = new StageThread();
+		m_stageThread->start(QThread::LowPriority);
+	}
+
+	//Local copies are kept until the job has finished, so count all of them against the budget
+	const qint64 budget = qint64(m_preferences->getStageInputBudget()) << 30;
+	qint64 usedSpace = 0;
+	for(QVector<job_t>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
+	{
+		usedSpace += iter->descriptor.getInputStageSize();
+	}
+
+	unsigned int count = 0;
+	for(QVector<job_t>::Iterator iter = m_jobs.begin(); (iter != m_jobs.end()) && (count < lookAhead); iter++)
+	{
+		if((iter->status == JobStatus_Enqueued) && iter->descriptor.isValid())
+		{
+			if(!iter->descriptor.getInputStage().isNull())
+			{
+				count++;
+				continue;
+			}
+			const QSharedPointer<InputStage> stage = iter->descriptor.createInputStage(m_sysinfo, budget - usedSpace);
+			if(!stage.isNull())
+			{
+				usedSpace += stage->getSize();
+				m_stageThread->enqueue(stage);
+				count++;
+			}
+		}
+	}
+}
+
+void JobListModel::archiveJobs(void)
+{
+	const qint64 maxAge = qint64(m_preferences->getArchiveJobsAge()) * 60000;
+	const int maxCount = int(m_preferences->getArchiveJobsCount());
+	if((maxAge < 1) && (maxCount < 1))
+	{
+		return;
+	}
+
+	//Newest first, so that the most recently finished jobs are the ones that are kept
+	QList<QPair<qint64, int>> finished;
+	for(int row = 0; row < m_jobs.count(); row++)
+	{
+		if(m_jobs.at(row).finishedAt > 0)
+		{
+			finished << qMakePair(-m_jobs.at(row).finishedAt, row);
+		}
+	}
+	std::sort(finished.begin(), finished.end());
+
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	for(int i = 0; i < finished.count(); i++)
+	{
+		job_t &job = m_jobs[finished.at(i).second];
+		if(isArchived(job))
+		{
+			continue;
+		}
+		if(((maxCount > 0) && (i >= maxCount)) || ((maxAge > 0) && ((now + finished.at(i).first) >= maxAge)))
+		{
+			archiveJob(job);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Private functions
+///////////////////////////////////////////////////////////////////////////////
+
+int JobListModel::getRow(const QUuid &jobId) const
+{
+	QHash<QUuid, int>::ConstIterator iter = m_rows.constFind(jobId);
+	return (iter != m_rows.constEnd()) ? iter.value() : -1;
+}
+
+void JobListModel::updateRows(const int &first, const int &last)
+{
+	for(int row = qMax(0, first); row <= qMin(last, m_jobs.count() - 1); row++)
+	{
+		m_rows.insert(m_jobs.at(row).id, row);
+	}
+}
+
+void JobListModel::addName(const QString &name)
+{
+	m_names[name.toLower()]++;
+}
+
+void JobListModel::removeName(const QString &name)
+{
+	const QString key = name.toLower();
+	QHash<QString, int>::Iterator iter = m_names.find(key);
+	if((iter != m_names.end()) && ((--iter.value()) < 1))
+	{
+		m_names.erase(iter);
+	}
+}
+
+bool JobListModel::archiveJob(job_t &job)
+{
+	if(job.thread)
+	{
+		return false; /*thread is still cleaning up, try again later*/
+	}
+
+	//Jobs without descriptor, e.g. recovered ones, only have their log dropped from memory
+	if(job.descriptor.options())
+	{
+		QDir().mkpath(QFileInfo(getArchiveFile(job.id)).absolutePath());
+		QSettings settings(getArchiveFile(job.id), QSettings::IniFormat);
+		settings.clear();
+		settings.setValue(KEY_SOURCE_FILE, job.descriptor.sourceFileName());
+		settings.setValue(KEY_OUTPUT_FILE, job.descriptor.outputFileName());
+		settings.beginGroup(KEY_ENC_OPTIONS);
+		OptionsModel::saveOptions(job.descriptor.options(), settings);
+		settings.endGroup();
+		settings.sync();
+		if(settings.status() != QSettings::NoError)
+		{
+			qWarning("Failed to write archive file for job, keeping it in memory!");
+			return false;
+		}
+		job.descriptor.dropOptions();
+	}
+
+	if(job.logFile)
+	{
+		job.logFile->unload();
+	}
+
+	return true;
+}
+
+/*
+ * Most queued jobs are never looked at before they are started, so their log model is only created when needed
+ */
+LogFileModel *JobListModel::createLogFile(job_t &job)
+{
+	if(!job.logFile)
+	{
+		job.logFile = new LogFileModel(job.id, m_logIndex, job.descriptor.sourceFileName(), job.descriptor.outputFileName(), job.config);
+	}
+
+	return job.logFile;
+}
+
+bool JobListModel::isArchived(const job_t &job)
+{
+	return job.descriptor.isValid() && (!job.descriptor.options());
+}
+
+QString JobListModel::getArchiveFile(const QUuid &jobId)
+{
+	return QString("%1/archive/%2.ini").arg(x264_data_path(), jobId.toString().mid(1, 36));
+}
+
+/*
+ * Statistics are appended to a plain tab-separated log, one line per finished job, so that
+ * saving never has to parse what was written before. The log is rotated to keep it bounded.
+ */
+void JobListModel::saveStatistics(const job_t &job)
+{
+	const QString fileName = QString("%1/statistics.log").arg(x264_data_path());
+	if(QFileInfo(fileName).size() > MAX_STATISTICS_SIZE)
+	{
+		QFile::remove(QString("%1.old").arg(fileName));
+		QFile::rename(fileName, QString("%1.old").arg(fileName));
+	}
+
+	QFile file(fileName);
+	if(!file.open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		qWarning("Failed to open statistics file for writing!");
+		return;
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+	if(file.size() == 0)
+	{
+		stream << KEY_FINISHED_AT << '\t' << "job_id" << '\t' << KEY_JOB_NAME << '\t' << KEY_JOB_STATUS << '\t' << KEY_SOURCE_FILE << '\t' << KEY_OUTPUT_FILE << '\t';
+		stream << KEY_USER_TIME << '\t' << KEY_KERNEL_TIME << '\t' << KEY_PEAK_MEMORY << '\t' << KEY_PEAK_COMMIT << '\t';
+		stream << KEY_READ_BYTES << '\t' << KEY_WRITE_BYTES << '\t' << KEY_READ_OPS << '\t' << KEY_WRITE_OPS << '\t' << KEY_PROCESSES << '\n';
+	}
+
+	const JobStatistics &stats = job.statistics;
+	stream << QDateTime::currentDateTime().toString(Qt::ISODate) << '\t' << job.id.toString().mid(1, 36) << '\t' << QString(job.name).replace('\t', ' ') << '\t' << static_cast<int>(job.status) << '\t';
+	stream << job.descriptor.sourceFileName() << '\t' << job.descriptor.outputFileName() << '\t';
+	stream << stats.userTime << '\t' << stats.kernelTime << '\t' << stats.peakWorkingSet << '\t' << stats.peakCommitted << '\t';
+	stream << stats.readBytes << '\t' << stats.writeBytes << '\t' << stats.readOperations << '\t' << stats.writeOperations << '\t' << stats.processCount << '\n';
+}
+
 size_t JobListModel::saveQueuedJobs(void)
 {
 	const QString appDir = x264_data_path();
@@ -568,24 +1184,25 @@ size_t JobListModel::saveQueuedJobs(void)
 	settings.setValue(KEY_ENTRY_COUNT, 0);
 	size_t jobCounter = 0;
 
-	for(QList<QUuid>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
+	for(QVector<job_t>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
 	{
-		if(m_status.value(*iter) == JobStatus_Enqueued)
+		if((iter->status == JobStatus_Enqueued) && iter->descriptor.options())
 		{
-			if(const EncodeThread *thread = m_threads.value(*iter))
-			{
-				settings.beginGroup(QString().sprintf(JOB_TEMPLATE, jobCounter++));
-				settings.setValue(KEY_SOURCE_FILE, thread->sourceFileName());
-				settings.setValue(KEY_OUTPUT_FILE, thread->outputFileName());
+			const JobDescriptor &job = iter->descriptor;
+			settings.beginGroup(QString().sprintf(JOB_TEMPLATE, jobCounter++));
+			settings.setValue(KEY_SOURCE_FILE, job.sourceFileName());
+			settings.setValue(KEY_OUTPUT_FILE, job.outputFileName());
+			settings.setValue(KEY_INTERACTIVE, job.isInteractive());
+			settings.setValue(KEY_IO_PRIORITY, job.getIoPriority());
+			settings.setValue(KEY_IO_LIMIT,    job.getIoBandwidthLimit());
 
-				settings.beginGroup(KEY_ENC_OPTIONS);
-				OptionsModel::saveOptions(thread->options(), settings);
+			settings.beginGroup(KEY_ENC_OPTIONS);
+			OptionsModel::saveOptions(job.options(), settings);
 
-				settings.endGroup();
-				settings.endGroup();
+			settings.endGroup();
+			settings.endGroup();
 
-				settings.setValue(KEY_ENTRY_COUNT, jobCounter);
-			}
+			settings.setValue(KEY_ENTRY_COUNT, jobCounter);
 		}
 	}
 
@@ -615,12 +1232,29 @@ size_t JobListModel::loadQueuedJobs(const SysinfoModel *sysinfo)
 		}
 	}
 
+	QElapsedTimer timer;
+	timer.start();
+
+	m_jobs.reserve(m_jobs.count() + int(jobCounter));
+	m_rows.reserve(m_jobs.count() + int(jobCounter));
+
 	size_t jobsCreated = 0;
 	for(size_t i = 0; i < jobCounter; i++)
 	{
 		settings.beginGroup(QString().sprintf(JOB_TEMPLATE, i));
 		const QString sourceFileName = settings.value(KEY_SOURCE_FILE, QString()).toString().trimmed();
 		const QString outputFileName = settings.value(KEY_OUTPUT_FILE, QString()).toString().trimmed();
+		const bool interactive = settings.value(KEY_INTERACTIVE, false).toBool();
+		int ioPriority = settings.value(KEY_IO_PRIORITY, JobDescriptor::IO_PRIORITY_DEFAULT).toInt();
+		int ioBandwidthLimit = settings.value(KEY_IO_LIMIT, JobDescriptor::IO_BANDWIDTH_DEFAULT).toInt();
+		if((ioPriority != JobDescriptor::IO_PRIORITY_DEFAULT) && ((ioPriority < -2) || (ioPriority > 0)))
+		{
+			ioPriority = JobDescriptor::IO_PRIORITY_DEFAULT;
+		}
+		if((ioBandwidthLimit != JobDescriptor::IO_BANDWIDTH_DEFAULT) && ((ioBandwidthLimit < 0) || (ioBandwidthLimit > 4096)))
+		{
+			ioBandwidthLimit = JobDescriptor::IO_BANDWIDTH_DEFAULT;
+		}
 
 		if(sourceFileName.isEmpty() || outputFileName.isEmpty())
 		{
@@ -637,15 +1271,252 @@ size_t JobListModel::loadQueuedJobs(const SysinfoModel *sysinfo)
 
 		if(okay)
 		{
-			EncodeThread *thread = new EncodeThread(sourceFileName, outputFileName, &options, sysinfo, m_preferences);
-			insertJob(thread);
+			JobDescriptor job(sourceFileName, outputFileName, &options);
+			job.setInteractive(interactive);
+			job.setIoClass(ioPriority, ioBandwidthLimit);
+			insertJob(job, true);
 			jobsCreated++;
 		}
 	}
 
+	//The look-ahead walks the whole queue, so it is only updated once all jobs have been inserted
+	if(jobsCreated > 0)
+	{
+		updateLookAhead();
+	}
+
+	qDebug("Restored %u queued job(s) in %lld ms.", static_cast<unsigned int>(jobsCreated), timer.elapsed());
 	return jobsCreated;
 }
 
+size_t JobListModel::recoverJobs(void)
+{
+	const QList<QUuid> orphans = JobSpool::findOrphans();
+	size_t jobsRecovered = 0;
+	bool recovered = false;
+
+	for(QList<QUuid>::ConstIterator iter = orphans.constBegin(); iter != orphans.constEnd(); iter++)
+	{
+		const QUuid id = *iter;
+		if(m_rows.contains(id))
+		{
+			continue;
+		}
+
+		JobSpool *spool = new JobSpool(id);
+		if(!spool->load(m_sysinfo))
+		{
+			spool->remove();
+			MUTILS_DELETE(spool);
+			continue;
+		}
+
+		LogFileModel *logFile = new LogFileModel(id, m_logIndex, spool->getSourceFile(), spool->getOutputFile(), tr("Recovered"));
+		//The lines of a multi-line message share the same sequence number, so they are passed on together
+		const QList<JobSpool::LogEntry> &logEntries = spool->getLogEntries();
+		for(int i = 0; i < logEntries.count(); i++)
+		{
+			QStringList message(logEntries.at(i).text);
+			while(((i + 1) < logEntries.count()) && (logEntries.at(i + 1).sequence == logEntries.at(i).sequence))
+			{
+				message << logEntries.at(++i).text;
+			}
+			logFile->addLogMessage(id, logEntries.at(i).sequence, logEntries.at(i).timeStamp, message.join("\n"));
+		}
+
+		//Jobs that have been recovered before only need their final status to be restored
+		const bool finished = (spool->getFinalStatus() >= 0);
+		const bool running = (!finished) && spool->attach();
+		if(!finished)
+		{
+			const qint64 timeStamp = QDateTime::currentMSecsSinceEpoch();
+			const QString message = running
+				? tr("\n--- RECOVERED ---\n\nApplication was restarted, re-attached to the running encoder process #%1.").arg(QString::number(spool->getProcessId()))
+				: tr("\n--- RECOVERED ---\n\nApplication terminated unexpectedly and the encoder process is not running anymore!");
+			logFile->addLogMessage(id, LogWriter::append(id, timeStamp, message), timeStamp, message);
+			if(!running)
+			{
+				LogWriter::close(id);
+			}
+		}
+
+		job_t record;
+		record.id = id;
+		record.name = QString("%1 [%2]").arg(QFileInfo(spool->getSourceFile()).completeBaseName().simplified(), tr("Recovered"));
+		record.config = tr("Recovered");
+		record.logFile = logFile;
+		record.spooled = true;
+
+		//With the options available, the recovered job can be restarted
+		if(spool->getOptions())
+		{
+			record.descriptor = JobDescriptor(spool->getSourceFile(), spool->getOutputFile(), spool->getOptions(), id);
+		}
+
+		if(running)
+		{
+			record.status = JobStatus_Running;
+			record.details = tr("Re-attached to running encoder, progress is not available.");
+			record.recovered = spool;
+			recovered = true;
+		}
+		else
+		{
+			record.status = finished ? static_cast<JobStatus>(spool->getFinalStatus()) : JobStatus_Failed;
+			switch(record.status)
+			{
+			case JobStatus_Completed:
+				record.progress = 100;
+				record.details = tr("Encode completed successfully.");
+				break;
+			case JobStatus_Aborted:
+				record.details = tr("The job was aborted by the user!");
+				break;
+			default:
+				record.status = JobStatus_Failed;
+				record.details = tr("The job has failed. See log for details!");
+				break;
+			}
+			if(!finished)
+			{
+				spool->finish(record.status);
+			}
+			MUTILS_DELETE(spool);
+		}
+
+		beginInsertRows(QModelIndex(), m_jobs.count(), m_jobs.count());
+		m_rows.insert(id, m_jobs.count());
+		m_jobs.append(record);
+		addName(record.name);
+		endInsertRows();
+
+		jobsRecovered++;
+	}
+
+	if(recovered)
+	{
+		if(!m_recoveryTimer)
+		{
+			m_recoveryTimer = new QTimer(this);
+			connect(m_recoveryTimer, SIGNAL(timeout()), this, SLOT(checkRecoveredJobs()));
+		}
+		m_recoveryTimer->start(2500);
+	}
+
+	return jobsRecovered;
+}
+
+void JobListModel::checkRecoveredJobs(void)
+{
+	bool recovered = false;
+	for(int row = 0; row < m_jobs.count(); row++)
+	{
+		const QUuid id = m_jobs.at(row).id;
+		JobSpool *spool = m_jobs.at(row).recovered;
+		if(!spool)
+		{
+			continue;
+		}
+
+		if(spool->isRunning())
+		{
+			const QFileInfo outputFile(spool->getOutputFile());
+			updateDetails(id, tr("Re-attached to running encoder, current file size is %1.").arg(AbstractEncoder::sizeToString(outputFile.exists() ? outputFile.size() : 0)));
+			recovered = true;
+			continue;
+		}
+
+		const int exitCode = spool->getExitCode();
+		const bool aborted = (m_jobs.at(row).status == JobStatus_Aborting);
+		const bool incomplete = (!aborted) && (exitCode == EXIT_SUCCESS) && spool->isIncomplete();
+		const qint64 timeStamp = QDateTime::currentMSecsSinceEpoch();
+		QString message = aborted ? tr("\nPROCESS ABORTED BY USER !!!") : tr("\nEncoder process exited with code %1.").arg(QString::number(exitCode));
+		if(incomplete)
+		{
+			message += (spool->getPass() == 1)
+				? tr("\nOnly the first pass of the 2-pass encode has completed, please restart the job!")
+				: tr("\nThe encoder's input was fed by the application, so the encode is *incomplete*, please restart the job!");
+		}
+		const qint64 sequence = LogWriter::append(id, timeStamp, message);
+		if(LogFileModel *logFile = m_jobs.at(row).logFile)
+		{
+			logFile->addLogMessage(id, sequence, timeStamp, message);
+		}
+		LogWriter::close(id);
+
+		if(aborted)
+		{
+			updateDetails(id, tr("The job was aborted by the user!"));
+			updateStatus(id, JobStatus_Aborted);
+		}
+		else if((exitCode == EXIT_SUCCESS) && (!incomplete))
+		{
+			const QFileInfo outputFile(spool->getOutputFile());
+			updateDetails(id, tr("Encode completed successfully. Final size is %1.").arg(AbstractEncoder::sizeToString(outputFile.exists() ? outputFile.size() : 0)));
+			updateProgress(id, 100);
+			updateStatus(id, JobStatus_Completed);
+		}
+		else
+		{
+			updateDetails(id, tr("The job has failed. See log for details!"));
+			updateStatus(id, JobStatus_Failed);
+		}
+
+		//Keep the spool with the final status, until the job is deleted from the list
+		m_jobs[row].recovered = NULL;
+		spool->finish(m_jobs.at(row).status);
+		MUTILS_DELETE(spool);
+	}
+
+	if((!recovered) && m_recoveryTimer)
+	{
+		m_recoveryTimer->stop();
+	}
+}
+
+void JobListModel::threadFinished(void)
+{
+	EncodeThread *const thread = qobject_cast<EncodeThread*>(sender());
+	if(!thread)
+	{
+		return;
+	}
+
+	thread->wait();
+	const int row = getRow(thread->getId());
+	if(row >= 0)
+	{
+		//Spool and local copy are no longer needed once the job has finished
+		m_jobs[row].thread = NULL;
+		m_jobs[row].descriptor.releaseLookAhead(false);
+	}
+	MUTILS_DELETE(thread);
+
+	updateLookAhead();
+	QTimer::singleShot(0, this, SLOT(archiveJobs()));
+}
+
+/*
+ * Memory usage is sampled for the whole lifetime of each job, including the pre-/post-processing
+ * stages that run outside of the encoder loop. The timer stops once no job is running any more.
+ */
+void JobListModel::sampleResourceUsage(void)
+{
+	bool running = false;
+	for(QVector<job_t>::ConstIterator iter = m_jobs.constBegin(); iter != m_jobs.constEnd(); iter++)
+	{
+		if(EncodeThread *const thread = iter->thread)
+		{
+			thread->sampleResourceUsage();
+			running = true;
+		}
+	}
+	if(!running)
+	{
+		m_sampleTimer->stop();
+	}
+}
+
 void JobListModel::clearQueuedJobs(void)
 {
 	const QString appDir = x264_data_path();
@@ -23,20 +23,30 @@
 
 #include "thread_encode.h"
 #include "model_logFile.h"
+#include "job_descriptor.h"
 
 #include "QAbstractItemModel"
 #include <QUuid>
 #include <QList>
-#include <QMap>
+#include <QVector>
+#include <QHash>
+#include <QScopedPointer>
 
 class PreferencesModel;
+class SysinfoModel;
+class OptionsModel;
+class JobSpool;
+class QTimer;
+class RenderThread;
+class StageThread;
+class LogIndex;
 
 class JobListModel : public QAbstractItemModel
 {
 	Q_OBJECT
 		
 public:
-	JobListModel(PreferencesModel *preferences);
+	JobListModel(PreferencesModel *preferences, const SysinfoModel *sysinfo);
 	~JobListModel(void);
 
 	virtual int columnCount(const QModelIndex &parent) const;
@@ -46,7 +56,7 @@ public:
 	virtual QModelIndex parent (const QModelIndex &index) const;
 	virtual QVariant data(const QModelIndex &index, int role) const;
 
-	QModelIndex insertJob(EncodeThread *thread);
+	QModelIndex insertJob(const JobDescriptor &job, const bool &deferLookAhead = false);
 	bool startJob(const QModelIndex &index);
 	bool pauseJob(const QModelIndex &index);
 	bool resumeJob(const QModelIndex &index);
@@ -54,16 +64,25 @@ public:
 	bool deleteJob(const QModelIndex &index);
 	bool moveJob(const QModelIndex &index, const int &direction);
 	LogFileModel *getLogFile(const QModelIndex &index);
+	const LogIndex *getLogIndex(void) const;
 	const QString &getJobSourceFile(const QModelIndex &index);
 	const QString &getJobOutputFile(const QModelIndex &index);
 	JobStatus getJobStatus(const QModelIndex &index);
 	unsigned int getJobProgress(const QModelIndex &index);
 	const OptionsModel *getJobOptions(const QModelIndex &index);
 	QModelIndex getJobIndexById(const QUuid &id);
+	const JobStatistics *getJobStatistics(const QModelIndex &index);
+	bool getJobInteractive(const QModelIndex &index);
+	bool setJobInteractive(const QModelIndex &index, const bool &interactive);
+	bool getJobIoClass(const QModelIndex &index, int &ioPriority, int &ioBandwidthLimit);
+	bool setJobIoClass(const QModelIndex &index, const int &ioPriority, const int &ioBandwidthLimit);
+	void updateIoClasses(void);
+	void updateLookAhead(void);
 
 	size_t saveQueuedJobs(void);
 	size_t loadQueuedJobs(const SysinfoModel *sysinfo);
 	void clearQueuedJobs(void);
+	size_t recoverJobs(void);
 
 	typedef enum
 	{
@@ -73,17 +92,65 @@ public:
 	move_t;
 
 protected:
-	QList<QUuid> m_jobs;
-	QMap<QUuid, QString> m_name;
-	QMap<QUuid, EncodeThread*> m_threads;
-	QMap<QUuid, JobStatus> m_status;
-	QMap<QUuid, unsigned int> m_progress;
-	QMap<QUuid, LogFileModel*> m_logFile;
-	QMap<QUuid, QString> m_details;
+	struct job_t
+	{
+		job_t(void) : status(JobStatus_Enqueued), progress(0), thread(NULL), logFile(NULL), recovered(NULL), spooled(false), hasStatistics(false), finishedAt(0) {}
+		QUuid id;
+		QString name;
+		QString config;
+		JobStatus status;
+		unsigned int progress;
+		QString details;
+		JobDescriptor descriptor;
+		EncodeThread *thread;
+		LogFileModel *logFile;
+		JobSpool *recovered;
+		bool spooled;
+		JobStatistics statistics;
+		bool hasStatistics;
+		QString volume;
+		qint64 finishedAt;
+	};
+
+	QVector<job_t> m_jobs;
+	QHash<QUuid, int> m_rows;
+	QHash<QString, int> m_names;
+	QTimer *m_recoveryTimer;
+	QTimer *m_archiveTimer;
+	QTimer *m_sampleTimer;
+	RenderThread *m_renderThread;
+	StageThread *m_stageThread;
+	LogIndex *m_logIndex;
 	PreferencesModel *m_preferences;
+	const SysinfoModel *m_sysinfo;
+
+	QScopedPointer<OptionsModel> m_archivedOptions;
+	QUuid m_archivedOptionsId;
+
+	int getRow(const QUuid &jobId) const;
+	void updateRows(const int &first, const int &last);
+	void addName(const QString &name);
+	void removeName(const QString &name);
+
+	LogFileModel *createLogFile(job_t &job);
+	bool archiveJob(job_t &job);
+	static bool isArchived(const job_t &job);
+	static QString getArchiveFile(const QUuid &jobId);
+
+	void saveStatistics(const job_t &job);
+	void updateRenderAhead(void);
+	void updateInputStaging(void);
 
 public slots:
 	void updateStatus(const QUuid &jobId, JobStatus newStatus);
 	void updateProgress(const QUuid &jobId, unsigned int newProgress);
 	void updateDetails(const QUuid &jobId, const QString &details);
+	void updateStatistics(const QUuid &jobId, const JobStatistics &statistics);
+	void updateOutputFile(const QUuid &jobId, const QString &outputFile);
+	void archiveJobs(void);
+
+private slots:
+	void checkRecoveredJobs(void);
+	void threadFinished(void);
+	void sampleResourceUsage(void);
 };
@@ -21,24 +21,46 @@
 
 #include "model_logFile.h"
 #include "thread_encode.h"
+#include "thread_log.h"
+#include "model_logIndex.h"
 
 #include <QIcon>
 #include <QApplication>
 #include <QClipboard>
 #include <QDir>
+#include <QFileInfo>
 #include <QTextStream>
 #include <QDateTime>
+#include <QTimer>
+#include <QScopedPointer>
 
 static const QLatin1String FMT_TIMESTAMP("[yyyy-MM-dd][HH:mm:ss] ");
 
-LogFileModel::LogFileModel(const QString &sourceName, const QString &outputName, const QString &configName)
+//New lines are made visible to the view at most this often
+static const int UPDATE_INTERVAL = 40;
+
+LogFileModel::LogFileModel(const QUuid &jobId, LogIndex *const logIndex, const QString &sourceName, const QString &outputName, const QString &configName)
+:
+	m_jobId(jobId),
+	m_logIndex(logIndex),
+	m_finished(false),
+	m_unloaded(false),
+	m_lastSequence(0),
+	m_lastSecond(-1)
 {
+	m_updateTimer = new QTimer(this);
+	m_updateTimer->setSingleShot(true);
+	m_updateTimer->setInterval(UPDATE_INTERVAL);
+	connect(m_updateTimer, SIGNAL(timeout()), this, SLOT(publishLines()));
+
 	const qint64 timeStamp = QDateTime::currentMSecsSinceEpoch();
-	m_lines << qMakePair(timeStamp, QString("Job not started yet."));
-	m_lines << qMakePair(timeStamp, QString());
-	m_lines << qMakePair(timeStamp, QString("Scheduled source: %1").arg(QDir::toNativeSeparators(sourceName)));
-	m_lines << qMakePair(timeStamp, QString("Scheduled output: %1").arg(QDir::toNativeSeparators(outputName)));
-	m_lines << qMakePair(timeStamp, QString("Scheduled config: %1").arg(configName));
+	m_lines.append(timeStamp, QString("Job not started yet."));
+	m_lines.append(timeStamp, QString());
+	m_lines.append(timeStamp, QString("Scheduled source: %1").arg(QDir::toNativeSeparators(sourceName)));
+	m_lines.append(timeStamp, QString("Scheduled output: %1").arg(QDir::toNativeSeparators(outputName)));
+	m_lines.append(timeStamp, QString("Scheduled config: %1").arg(configName));
+	m_lines.squeeze();
+	m_rows = m_lines.count();
 	m_firstLine = true;
 }
 
@@ -57,7 +79,8 @@ int LogFileModel::columnCount(const QModelIndex &parent) const
 
 int LogFileModel::rowCount(const QModelIndex &parent) const
 {
-	return m_lines.count();
+	ensureLoaded();
+	return m_rows;
 }
 
 QVariant LogFileModel::headerData(int section, Qt::Orientation orientation, int role) const 
@@ -79,17 +102,16 @@ QVariant LogFileModel::data(const QModelIndex &index, int role) const
 {
 	if((role == Qt::DisplayRole) || (role == Qt::ToolTipRole))
 	{
-		if(index.row() >= 0 && index.row() < m_lines.count() && index.column() == 0)
+		ensureLoaded();
+		if(index.row() >= 0 && index.row() < m_rows && index.column() == 0)
 		{
 			if (role == Qt::ToolTipRole)
 			{
-				const LogEntry &entry = m_lines.at(index.row());
-				const QString timeStamp = QDateTime::fromMSecsSinceEpoch(entry.first).toString(FMT_TIMESTAMP);
-				return timeStamp + entry.second;
+				return formatLine(index.row());
 			}
 			else
 			{
-				return m_lines.at(index.row()).second;
+				return m_lines.text(index.row());
 			}
 		}
 	}
@@ -103,18 +125,21 @@ QVariant LogFileModel::data(const QModelIndex &index, int role) const
 
 void LogFileModel::copyToClipboard(void) const
 {
+	ensureLoaded();
+
 	QClipboard *const clipboard = QApplication::clipboard();
 	QStringList buffer;
-	for (QList<LogEntry>::ConstIterator iter = m_lines.constBegin(); iter != m_lines.constEnd(); iter++)
+	for (int i = 0; i < m_lines.count(); i++)
 	{
-		const QString timeStamp = QDateTime::fromMSecsSinceEpoch(iter->first).toString(FMT_TIMESTAMP);
-		buffer << (timeStamp + iter->second);
+		buffer << formatLine(i);
 	}
 	clipboard->setText(buffer.join("\r\n"));
 }
 
 bool LogFileModel::saveToLocalFile(const QString &fileName) const
 {
+	ensureLoaded();
+
 	QFile file(fileName);
 	if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
 	{
@@ -125,10 +150,9 @@ bool LogFileModel::saveToLocalFile(const QString &fileName) const
 	stream.setCodec("UTF-8");
 	stream.setGenerateByteOrderMark(true);
 
-	for(QList<LogEntry>::ConstIterator iter = m_lines.constBegin(); iter != m_lines.constEnd(); iter++)
+	for(int i = 0; i < m_lines.count(); i++)
 	{
-		const QString timeStamp = QDateTime::fromMSecsSinceEpoch(iter->first).toString(FMT_TIMESTAMP);
-		stream << timeStamp << iter->second << QLatin1String("\r\n");
+		stream << formatLine(i) << QLatin1String("\r\n");
 		if(stream.status() != QTextStream::Status::Ok)
 		{
 			file.close();
@@ -147,25 +171,153 @@ bool LogFileModel::saveToLocalFile(const QString &fileName) const
 	return true;
 }
 
+QStringList LogFileModel::getLines(const QList<int> &rows) const
+{
+	QStringList lines;
+
+	//Do not keep an unloaded log in memory, just for looking up a few lines
+	QScopedPointer<LogStore> temp;
+	if(m_unloaded)
+	{
+		temp.reset(new LogStore());
+		const QList<LogWriter::LogEntry> entries = LogWriter::load(m_jobId);
+		for(QList<LogWriter::LogEntry>::ConstIterator iter = entries.constBegin(); iter != entries.constEnd(); iter++)
+		{
+			temp->append(iter->timeStamp, iter->text);
+		}
+	}
+
+	const LogStore &store = temp.isNull() ? m_lines : (*temp);
+	for(QList<int>::ConstIterator iter = rows.constBegin(); iter != rows.constEnd(); iter++)
+	{
+		lines << (((*iter >= 0) && (*iter < store.count())) ? store.text(*iter) : QString());
+	}
+
+	return lines;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Slots
 ///////////////////////////////////////////////////////////////////////////////
 
-void LogFileModel::addLogMessage(const QUuid &jobId, const qint64 &timeStamp, const QString &text)
+void LogFileModel::addLogMessage(const QUuid &jobId, const qint64 &sequence, const qint64 &timeStamp, const QString &text)
 {
-	beginInsertRows(QModelIndex(), m_lines.count(), m_lines.count());
+	ensureLoaded();
+
+	//The message may have been written to the log file before the model was reloaded from it
+	if(sequence <= m_lastSequence)
+	{
+		return;
+	}
+	m_lastSequence = sequence;
 
 	if(m_firstLine)
 	{
+		beginResetModel();
 		m_firstLine = false;
 		m_lines.clear();
+		m_rows = 0;
+		endResetModel();
 	}
 
+	//Lines are stored right away, but the view only learns about them once per update interval
 	const QStringList lines = text.split("\n");
 	for(QStringList::ConstIterator iter = lines.constBegin(); iter != lines.constEnd(); iter++)
 	{
-		m_lines << qMakePair(timeStamp, (*iter));
+		m_lines.append(timeStamp, (*iter));
+		if(m_logIndex)
+		{
+			m_logIndex->addLine(m_jobId, m_lines.count() - 1, (*iter));
+		}
 	}
 
-	endInsertRows();
+	if(!m_updateTimer->isActive())
+	{
+		m_updateTimer->start();
+	}
+}
+
+void LogFileModel::publishLines(void)
+{
+	const int count = m_lines.count();
+	if(count > m_rows)
+	{
+		beginInsertRows(QModelIndex(), m_rows, count - 1);
+		m_rows = count;
+		endInsertRows();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal functions
+///////////////////////////////////////////////////////////////////////////////
+
+void LogFileModel::unload(void)
+{
+	if(m_firstLine || m_unloaded)
+	{
+		return; /*nothing to unload*/
+	}
+
+	//Make sure that all lines have been written, before they are dropped from memory
+	LogWriter::sync();
+	if(!QFileInfo(LogWriter::getLogFile(m_jobId)).exists())
+	{
+		return;
+	}
+
+	m_updateTimer->stop();
+	beginResetModel();
+	m_lines.clear();
+	m_rows = 0;
+	m_unloaded = true;
+	endResetModel();
+}
+
+/*
+ * The job has finished, so the log is not going to grow any more
+ */
+void LogFileModel::squeeze(void)
+{
+	m_finished = true;
+	m_lines.squeeze();
+}
+
+QString LogFileModel::formatLine(const int &index) const
+{
+	//The time stamp only has a resolution of seconds, so consecutive lines can share the string
+	const qint64 timeStamp = m_lines.timeStamp(index);
+	if((timeStamp / 1000) != m_lastSecond)
+	{
+		m_lastSecond = timeStamp / 1000;
+		m_lastTimeStamp = QDateTime::fromMSecsSinceEpoch(timeStamp).toString(FMT_TIMESTAMP);
+	}
+	return m_lastTimeStamp + m_lines.text(index);
+}
+
+void LogFileModel::ensureLoaded(void) const
+{
+	if(m_unloaded)
+	{
+		//Messages that were written after the log was unloaded have not been indexed yet
+		m_unloaded = false;
+		const QList<LogWriter::LogEntry> entries = LogWriter::load(m_jobId);
+		for(QList<LogWriter::LogEntry>::ConstIterator iter = entries.constBegin(); iter != entries.constEnd(); iter++)
+		{
+			m_lines.append(iter->timeStamp, iter->text);
+			if(m_logIndex && (iter->sequence > m_lastSequence))
+			{
+				m_logIndex->addLine(m_jobId, m_lines.count() - 1, iter->text);
+			}
+		}
+		if(!entries.isEmpty())
+		{
+			m_lastSequence = qMax(m_lastSequence, entries.last().sequence);
+		}
+		if(m_finished)
+		{
+			m_lines.squeeze();
+		}
+		m_rows = m_lines.count();
+	}
 }
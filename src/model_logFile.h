@@ -22,18 +22,22 @@
 #pragma once
 
 #include "thread_encode.h"
+#include "model_logStore.h"
 
 #include "QAbstractItemModel"
 #include <QUuid>
 #include <QList>
 #include <QMap>
 
+class QTimer;
+class LogIndex;
+
 class LogFileModel : public QAbstractItemModel
 {
 	Q_OBJECT
 		
 public:
-	LogFileModel(const QString &sourceName, const QString &outputName, const QString &configName);
+	LogFileModel(const QUuid &jobId, LogIndex *const logIndex, const QString &sourceName, const QString &outputName, const QString &configName);
 	~LogFileModel(void);
 
 	virtual int columnCount(const QModelIndex &parent) const;
@@ -45,12 +49,30 @@ public:
 
 	void copyToClipboard(void) const;
 	bool saveToLocalFile(const QString &fileName) const;
+	void unload(void);
+	void squeeze(void);
+	QStringList getLines(const QList<int> &rows) const;
 
 protected:
+	const QUuid m_jobId;
+	LogIndex *const m_logIndex;
 	bool m_firstLine;
-	typedef QPair<qint64, QString> LogEntry;
-	QList<LogEntry> m_lines;
+	bool m_finished;
+	mutable bool m_unloaded;
+	mutable qint64 m_lastSequence;
+	mutable LogStore m_lines;
+	mutable int m_rows;
+	QTimer *m_updateTimer;
+
+	mutable qint64 m_lastSecond;
+	mutable QString m_lastTimeStamp;
+
+	QString formatLine(const int &index) const;
+	void ensureLoaded(void) const;
 
 public slots:
-	void addLogMessage(const QUuid &jobId, const qint64 &timeStamp, const QString &text);
+	void addLogMessage(const QUuid &jobId, const qint64 &sequence, const qint64 &timeStamp, const QString &text);
+
+private slots:
+	void publishLines(void);
 };
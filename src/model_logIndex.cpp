@@ -0,0 +1,293 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "model_logIndex.h"
+#include "global.h"
+
+#include <algorithm>
+
+//Very short tokens would match nearly every line, so they are not indexed
+static const int MIN_TOKEN_LENGTH = 2;
+
+#define MAKE_KEY(SLOT, LINE) ((quint64(SLOT) << 32) | quint64(quint32(LINE)))
+#define KEY_SLOT(KEY) (quint32((KEY) >> 32))
+#define KEY_LINE(KEY) (int(quint32((KEY) & 0xFFFFFFFF)))
+
+static bool shorterPostings(const QVector<quint64> *const a, const QVector<quint64> *const b)
+{
+	return a->count() < b->count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+LogIndex::LogIndex(void)
+:
+	m_total(0),
+	m_dead(0)
+{
+}
+
+LogIndex::~LogIndex(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+void LogIndex::addLine(const QUuid &jobId, const int &line, const QString &text)
+{
+	quint32 slot;
+	QHash<QUuid, quint32>::ConstIterator iter = m_slots.constFind(jobId);
+	if(iter != m_slots.constEnd())
+	{
+		slot = iter.value();
+	}
+	else
+	{
+		slot = quint32(m_jobs.count());
+		m_slots.insert(jobId, slot);
+		m_jobs.append(jobId);
+		m_postings.append(0);
+	}
+
+	//Lines of running jobs arrive interleaved, so keys that are out of order are collected at the end and merged by search()
+	const quint64 key = MAKE_KEY(slot, line);
+	const QStringList tokens = tokenize(text);
+	for(QStringList::ConstIterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
+	{
+		QHash<QString, postings_t>::Iterator iter = m_terms.find(*token);
+		if(iter == m_terms.end())
+		{
+			postings_t postings;
+			postings.sorted = 0;
+			iter = m_terms.insert(*token, postings);
+		}
+		QVector<quint64> &keys = iter->keys;
+		if(keys.isEmpty() || (keys.last() != key))
+		{
+			if((iter->sorted == keys.count()) && (keys.isEmpty() || (keys.last() < key)))
+			{
+				iter->sorted++;
+			}
+			keys.append(key);
+			m_postings[slot]++;
+			m_total++;
+		}
+	}
+}
+
+void LogIndex::removeJob(const QUuid &jobId)
+{
+	QHash<QUuid, quint32>::Iterator iter = m_slots.find(jobId);
+	if(iter == m_slots.end())
+	{
+		return;
+	}
+
+	//Postings of removed jobs are skipped by search() and purged once they make up half of the index
+	const quint32 slot = iter.value();
+	m_slots.erase(iter);
+	m_jobs[slot] = QUuid();
+	m_dead += m_postings[slot];
+	m_postings[slot] = 0;
+
+	if((m_dead > 0) && ((m_dead * 2) > m_total))
+	{
+		compact();
+	}
+}
+
+void LogIndex::clear(void)
+{
+	m_terms.clear();
+	m_slots.clear();
+	m_jobs.clear();
+	m_postings.clear();
+	m_total = m_dead = 0;
+}
+
+int LogIndex::search(const QString &query, QList<hit_t> &results, const int &maxResults) const
+{
+	results.clear();
+
+	QStringList tokens = tokenize(query);
+	tokens.removeDuplicates();
+	if(tokens.isEmpty())
+	{
+		return 0;
+	}
+
+	//All words must appear in the same line, start with the rarest one
+	QList<const QVector<quint64>*> lists;
+	for(QStringList::ConstIterator token = tokens.constBegin(); token != tokens.constEnd(); token++)
+	{
+		QHash<QString, postings_t>::Iterator iter = m_terms.find(*token);
+		if(iter == m_terms.end())
+		{
+			return 0;
+		}
+		lists << &sortPostings(iter.value());
+	}
+	std::sort(lists.begin(), lists.end(), shorterPostings);
+
+	//The lists are sorted, so each of the others only has to be searched forward from the previous match
+	QVector<int> positions(lists.count(), 0);
+	int total = 0;
+	const QVector<quint64> &rarest = *lists.first();
+	for(QVector<quint64>::ConstIterator key = rarest.constBegin(); key != rarest.constEnd(); key++)
+	{
+		if(m_jobs.at(KEY_SLOT(*key)).isNull())
+		{
+			continue;
+		}
+		bool matched = true;
+		for(int i = 1; matched && (i < lists.count()); i++)
+		{
+			const QVector<quint64> &keys = *lists.at(i);
+			positions[i] = gallop(keys, positions.at(i), *key);
+			matched = (positions.at(i) < keys.count()) && (keys.at(positions.at(i)) == (*key));
+		}
+		if(matched)
+		{
+			if(results.count() < maxResults)
+			{
+				hit_t hit;
+				hit.jobId = m_jobs.at(KEY_SLOT(*key));
+				hit.line = KEY_LINE(*key);
+				results << hit;
+			}
+			total++;
+		}
+	}
+
+	return total;
+}
+
+QStringList LogIndex::tokenize(const QString &text)
+{
+	QStringList tokens;
+	const int length = text.length();
+	int start = -1;
+
+	for(int i = 0; i <= length; i++)
+	{
+		const bool isWordChar = (i < length) && (text.at(i).isLetterOrNumber() || (text.at(i) == QLatin1Char('_')));
+		if(isWordChar)
+		{
+			if(start < 0) start = i;
+		}
+		else if(start >= 0)
+		{
+			if((i - start) >= MIN_TOKEN_LENGTH)
+			{
+				tokens << text.mid(start, i - start).toLower();
+			}
+			start = -1;
+		}
+	}
+
+	return tokens;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal Functions
+///////////////////////////////////////////////////////////////////////////////
+
+void LogIndex::compact(void)
+{
+	//Re-number the remaining jobs, so the slot tables do not grow forever
+	QVector<quint32> remap(m_jobs.count(), quint32(-1));
+	QVector<QUuid> jobs;
+	QVector<quint32> postings;
+	for(int i = 0; i < m_jobs.count(); i++)
+	{
+		if(!m_jobs.at(i).isNull())
+		{
+			remap[i] = quint32(jobs.count());
+			m_slots.insert(m_jobs.at(i), quint32(jobs.count()));
+			jobs.append(m_jobs.at(i));
+			postings.append(m_postings.at(i));
+		}
+	}
+
+	QHash<QString, postings_t>::Iterator iter = m_terms.begin();
+	while(iter != m_terms.end())
+	{
+		//Slots are re-numbered in the same order, so the filtered list stays sorted
+		QVector<quint64> filtered;
+		const QVector<quint64> &keys = sortPostings(iter.value());
+		for(QVector<quint64>::ConstIterator key = keys.constBegin(); key != keys.constEnd(); key++)
+		{
+			const quint32 slot = remap.at(KEY_SLOT(*key));
+			if(slot != quint32(-1))
+			{
+				filtered.append(MAKE_KEY(slot, KEY_LINE(*key)));
+			}
+		}
+		if(filtered.isEmpty())
+		{
+			iter = m_terms.erase(iter);
+		}
+		else
+		{
+			filtered.squeeze();
+			iter->keys.swap(filtered);
+			iter->sorted = iter->keys.count();
+			iter++;
+		}
+	}
+
+	m_jobs.swap(jobs);
+	m_postings.swap(postings);
+	m_total -= m_dead;
+	m_dead = 0;
+}
+
+const QVector<quint64> &LogIndex::sortPostings(postings_t &postings)
+{
+	//Only the keys that were appended out of order have to be sorted, then both parts are merged
+	if(postings.sorted < postings.keys.count())
+	{
+		QVector<quint64>::Iterator middle = postings.keys.begin() + postings.sorted;
+		std::sort(middle, postings.keys.end());
+		std::inplace_merge(postings.keys.begin(), middle, postings.keys.end());
+		postings.keys.erase(std::unique(postings.keys.begin(), postings.keys.end()), postings.keys.end());
+		postings.sorted = postings.keys.count();
+	}
+	return postings.keys;
+}
+
+int LogIndex::gallop(const QVector<quint64> &keys, const int &from, const quint64 &key)
+{
+	//Find the range that contains the key with growing steps, then do a binary search within that range
+	int lower = from, step = 1;
+	while(((lower + step) < keys.count()) && (keys.at(lower + step) < key))
+	{
+		lower += step;
+		step *= 2;
+	}
+	const int upper = qMin(lower + step + 1, keys.count());
+	return int(std::lower_bound(keys.constBegin() + lower, keys.constBegin() + upper, key) - keys.constBegin());
+}
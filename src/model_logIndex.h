@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QUuid>
+#include <QHash>
+#include <QVector>
+#include <QList>
+
+class LogIndex
+{
+public:
+	LogIndex(void);
+	~LogIndex(void);
+
+	typedef struct
+	{
+		QUuid jobId;
+		int line;
+	}
+	hit_t;
+
+	void addLine(const QUuid &jobId, const int &line, const QString &text);
+	void removeJob(const QUuid &jobId);
+	void clear(void);
+
+	int search(const QString &query, QList<hit_t> &results, const int &maxResults) const;
+
+	static QStringList tokenize(const QString &text);
+
+protected:
+	typedef struct
+	{
+		QVector<quint64> keys;
+		int sorted;
+	}
+	postings_t;
+
+	mutable QHash<QString, postings_t> m_terms;
+	QHash<QUuid, quint32> m_slots;
+	QVector<QUuid> m_jobs;
+	QVector<quint32> m_postings;
+	qint64 m_total;
+	qint64 m_dead;
+
+	void compact(void);
+	static const QVector<quint64> &sortPostings(postings_t &postings);
+	static int gallop(const QVector<quint64> &keys, const int &from, const quint64 &key);
+
+private:
+	//Disable copy constructor and assignment
+	LogIndex(const LogIndex &other) {}
+	LogIndex &operator=(const LogIndex &) {}
+};
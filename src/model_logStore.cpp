@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "model_logStore.h"
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QDir>
+#include <QFile>
+#include <QUuid>
+
+QMutex                                LogStore::s_mutex;
+QHash<quint64, LogStore*>             LogStore::s_stores;
+QList<LogStore::candidate_t>          LogStore::s_candidates;
+quint64                               LogStore::s_nextSerial = 0;
+qint64                                LogStore::s_resident = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+LogStore::LogStore(void)
+{
+	attach();
+}
+
+LogStore::~LogStore(void)
+{
+	clear();
+	detach();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+QString LogStore::text(const int &index) const
+{
+	const entry_t &entry = m_index.at(index);
+	const block_t &block = m_blocks.at(entry.block);
+	const char *const data = block.mapped ? reinterpret_cast<const char*>(block.mapped) : block.data.constData();
+	return QString::fromUtf8(data + entry.offset, entry.length);
+}
+
+/*
+ * Progress lines are consumed by the encoder parsers and never reach the log, so every line is kept as it is
+ */
+void LogStore::append(const qint64 &timeStamp, const QString &text)
+{
+	const QByteArray utf8 = text.toUtf8();
+
+	//Most logs are short, so the first block starts small and grows geometrically, up to the regular block size
+	if((!m_blocks.isEmpty()) && (!m_blocks.last().mapped))
+	{
+		block_t &last = m_blocks.last();
+		const int required = last.used + utf8.size();
+		if((required > last.data.size()) && (required <= BLOCK_SIZE))
+		{
+			const int grown = qMin(qMax(2 * last.data.size(), required), BLOCK_SIZE);
+			updateResident(grown - last.data.size());
+			last.data.resize(grown);
+		}
+	}
+
+	//Start a new block, if the line doesn't fit (the full block can be spilled from now on)
+	if(m_blocks.isEmpty() || (m_blocks.last().mapped) || ((m_blocks.last().used + utf8.size()) > m_blocks.last().data.size()))
+	{
+		if((!m_blocks.isEmpty()) && (!m_blocks.last().mapped))
+		{
+			addCandidate(m_serial, m_blocks.count() - 1);
+		}
+		block_t block;
+		block.data.resize(qMax(m_blocks.isEmpty() ? MIN_BLOCK_SIZE : BLOCK_SIZE, utf8.size()));
+		block.spillFile = NULL;
+		block.mapped = NULL;
+		block.used = 0;
+		block.pinned = false;
+		m_blocks.append(block);
+		updateResident(block.data.size());
+	}
+
+	block_t &block = m_blocks.last();
+	memcpy(block.data.data() + block.used, utf8.constData(), utf8.size());
+
+	entry_t entry;
+	entry.timeStamp = timeStamp;
+	entry.block = m_blocks.count() - 1;
+	entry.offset = block.used;
+	entry.length = utf8.size();
+	m_index.append(entry);
+
+	block.used += utf8.size();
+
+	enforceLimit();
+}
+
+/*
+ * Called when no more lines are expected for now: Releases the unused part of the current block and allows it to be
+ * spilled, like the full blocks. A line that is appended later simply starts a new block, if it has been spilled.
+ */
+void LogStore::squeeze(void)
+{
+	if(m_blocks.isEmpty() || m_blocks.last().mapped)
+	{
+		return;
+	}
+
+	block_t &last = m_blocks.last();
+	if(last.data.size() > last.used)
+	{
+		updateResident(last.used - last.data.size());
+		last.data.resize(last.used);
+		last.data.squeeze();
+	}
+
+	addCandidate(m_serial, m_blocks.count() - 1);
+	enforceLimit();
+}
+
+void LogStore::clear(void)
+{
+	qint64 resident = 0;
+	for(QVector<block_t>::Iterator iter = m_blocks.begin(); iter != m_blocks.end(); iter++)
+	{
+		if(iter->spillFile)
+		{
+			iter->spillFile->unmap(iter->mapped);
+			iter->spillFile->remove();
+			MUTILS_DELETE(iter->spillFile);
+		}
+		resident += iter->data.size();
+	}
+
+	m_index.clear();
+	m_blocks.clear();
+	updateResident(-resident);
+
+	//Blocks that are still waiting to be spilled must not be mistaken for the new ones
+	detach();
+	attach();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Memory Limit
+///////////////////////////////////////////////////////////////////////////////
+
+bool LogStore::spillBlock(const int &index)
+{
+	block_t &block = m_blocks[index];
+	if(block.mapped || block.pinned || (block.used < 1))
+	{
+		return false;
+	}
+
+	//Each block gets a file of its own, which is mapped exactly once and can be removed without affecting other blocks
+	QFile *spillFile = new QFile(QString("%1/~log_%2.tmp").arg(QDir::tempPath(), QUuid::createUuid().toString().mid(1, 36)));
+	uchar *mapped = NULL;
+	if(spillFile->open(QIODevice::ReadWrite | QIODevice::Truncate))
+	{
+		//Only the used part of the block is written, the mapping is read-only from now on
+		if((spillFile->write(block.data.constData(), block.used) == block.used) && spillFile->flush())
+		{
+			mapped = spillFile->map(0, block.used);
+		}
+	}
+
+	//Don't leave a partial file behind and never retry this block, it stays in memory for good
+	if(!mapped)
+	{
+		qWarning("Failed to spill log block to: %s", spillFile->fileName().toUtf8().constData());
+		spillFile->close();
+		spillFile->remove();
+		MUTILS_DELETE(spillFile);
+		block.pinned = true;
+		return false;
+	}
+
+	const qint64 released = block.data.size();
+	block.spillFile = spillFile;
+	block.mapped = mapped;
+	block.data = QByteArray();
+	updateResident(-released);
+
+	return true;
+}
+
+void LogStore::attach(void)
+{
+	QMutexLocker lock(&s_mutex);
+	m_serial = s_nextSerial++;
+	s_stores.insert(m_serial, this);
+}
+
+void LogStore::detach(void)
+{
+	QMutexLocker lock(&s_mutex);
+	s_stores.remove(m_serial);
+}
+
+void LogStore::addCandidate(const quint64 &store, const int &block)
+{
+	candidate_t candidate;
+	candidate.store = store;
+	candidate.block = block;
+
+	QMutexLocker lock(&s_mutex);
+	s_candidates.append(candidate);
+}
+
+/*
+ * Blocks are spilled in the order in which they became candidates, i.e. full blocks and the last block of logs that
+ * are not written to any more, oldest first. Each candidate is looked at only once, so this never walks all logs.
+ */
+void LogStore::enforceLimit(void)
+{
+	forever
+	{
+		LogStore *store = NULL;
+		int block = -1;
+		{
+			QMutexLocker lock(&s_mutex);
+			if((s_resident <= MAX_RESIDENT) || s_candidates.isEmpty())
+			{
+				return;
+			}
+			const candidate_t candidate = s_candidates.takeFirst();
+			store = s_stores.value(candidate.store, NULL);
+			block = candidate.block;
+		}
+
+		//The log may have been cleared or deleted in the meantime
+		if(store && (block < store->m_blocks.count()))
+		{
+			store->spillBlock(block);
+		}
+	}
+}
+
+void LogStore::updateResident(const qint64 &delta)
+{
+	QMutexLocker lock(&s_mutex);
+	s_resident += delta;
+}
@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+
+class QFile;
+
+class LogStore
+{
+public:
+	LogStore(void);
+	~LogStore(void);
+
+	int count(void) const { return m_index.count(); }
+	qint64 timeStamp(const int &index) const { return m_index.at(index).timeStamp; }
+	QString text(const int &index) const;
+
+	void append(const qint64 &timeStamp, const QString &text);
+	void squeeze(void);
+	void clear(void);
+
+protected:
+	static const int MIN_BLOCK_SIZE = 4096;
+	static const int BLOCK_SIZE = 262144;
+	static const qint64 MAX_RESIDENT = Q_INT64_C(33554432);
+
+	typedef struct
+	{
+		qint64 timeStamp;
+		quint32 block;
+		quint32 offset;
+		quint32 length;
+	}
+	entry_t;
+
+	typedef struct
+	{
+		QByteArray data;
+		QFile *spillFile;
+		uchar *mapped;
+		int used;
+		bool pinned;
+	}
+	block_t;
+
+	typedef struct
+	{
+		quint64 store;
+		int block;
+	}
+	candidate_t;
+
+	QVector<entry_t> m_index;
+	QVector<block_t> m_blocks;
+	quint64 m_serial;
+
+	//Memory limit
+	bool spillBlock(const int &index);
+	void attach(void);
+	void detach(void);
+	static void addCandidate(const quint64 &store, const int &block);
+	static void enforceLimit(void);
+	static void updateResident(const qint64 &delta);
+
+	static QMutex s_mutex;
+	static QHash<quint64, LogStore*> s_stores;
+	static QList<candidate_t> s_candidates;
+	static quint64 s_nextSerial;
+	static qint64 s_resident;
+
+private:
+	//Disable copy constructor and assignment
+	LogStore(const LogStore &other) {}
+	LogStore &operator=(const LogStore &) {}
+};
@@ -24,6 +24,7 @@
 //Internal
 #include "global.h"
 #include "model_sysinfo.h"
+#include "model_templates.h"
 
 //Mutils
 #include <MUtils/Global.h>
@@ -110,48 +111,38 @@ bool OptionsModel::equals(const OptionsModel *model)
 bool OptionsModel::saveTemplate(const OptionsModel *model, const QString &name)
 {
 	const QString templateName = name.simplified();
-	const QString appDir = x264_data_path();
 
 	if(templateName.contains('\\') || templateName.contains('/'))
 	{
 		return false;
 	}
 
-	QSettings settings(QString("%1/templates.ini").arg(appDir), QSettings::IniFormat);
-	settings.beginGroup(templateName);
+	QVariantMap values;
+	saveOptions(model, values);
 
-	const bool okay = saveOptions(model, settings);
-
-	settings.endGroup();
-	settings.sync();
-	
-	return okay;
+	return TemplateRegistry::put(templateName, values);
 }
 
 bool OptionsModel::loadTemplate(OptionsModel *model, const QString &name)
 {
-	const QString appDir = x264_data_path();
-	
 	if(name.contains('\\') || name.contains('/'))
 	{
 		return false;
 	}
-	
-	QSettings settings(QString("%1/templates.ini").arg(appDir), QSettings::IniFormat);
-	
-	settings.beginGroup(name);
-	const bool okay = loadOptions(model, settings);
-	settings.endGroup();
 
-	return okay;
+	QVariantMap values;
+	if(!TemplateRegistry::get(name, values))
+	{
+		return false;
+	}
+
+	return loadOptions(model, values);
 }
 
 QMap<QString, OptionsModel*> OptionsModel::loadAllTemplates(const SysinfoModel *sysinfo)
 {
 	QMap<QString, OptionsModel*> list;
-	const QString appDir = x264_data_path();
-	QSettings settings(QString("%1/templates.ini").arg(appDir), QSettings::IniFormat);
-	QStringList allTemplates = settings.childGroups();
+	QStringList allTemplates = TemplateRegistry::names();
 
 	while(!allTemplates.isEmpty())
 	{
@@ -173,103 +164,117 @@ QMap<QString, OptionsModel*> OptionsModel::loadAllTemplates(const SysinfoModel *
 
 bool OptionsModel::templateExists(const QString &name)
 {
-	const QString appDir = x264_data_path();
-	QSettings settings(QString("%1/templates.ini").arg(appDir), QSettings::IniFormat);
-	QStringList allGroups = settings.childGroups();
-	return allGroups.contains(name, Qt::CaseInsensitive);
+	return TemplateRegistry::contains(name);
 }
 
 bool OptionsModel::deleteTemplate(const QString &name)
 {
-	const QString appDir = x264_data_path();
-	QSettings settings(QString("%1/templates.ini").arg(appDir), QSettings::IniFormat);
+	return TemplateRegistry::remove(name);
+}
+
+bool OptionsModel::saveOptions(const OptionsModel *model, QSettings &settingsFile)
+{
+	QVariantMap values;
+	saveOptions(model, values);
 
-	if(settings.childGroups().contains(name, Qt::CaseInsensitive))
+	for(QVariantMap::ConstIterator iter = values.constBegin(); iter != values.constEnd(); iter++)
 	{
-		settings.remove(name);
-		return true;
+		settingsFile.setValue(iter.key(), iter.value());
 	}
 
-	return false;
+	return true;
 }
 
-bool OptionsModel::saveOptions(const OptionsModel *model, QSettings &settingsFile)
+bool OptionsModel::saveOptions(const OptionsModel *model, QVariantMap &values)
 {
-	settingsFile.setValue(KEY_ENCODER_TYPE,    model->m_encoderType);
-	settingsFile.setValue(KEY_ENCODER_ARCH,    model->m_encoderArch);
-	settingsFile.setValue(KEY_ENCODER_VARIANT, model->m_encoderVariant);
-	settingsFile.setValue(KEY_RATECTRL_MODE,   model->m_rcMode);
-	settingsFile.setValue(KEY_TARGET_BITRATE,  model->m_bitrate);
-	settingsFile.setValue(KEY_TARGET_QUANT,    model->m_quantizer);
-	settingsFile.setValue(KEY_PRESET_NAME,     model->m_preset);
-	settingsFile.setValue(KEY_TUNING_NAME,     model->m_tune);
-	settingsFile.setValue(KEY_PROFILE_NAME,    model->m_profile);
-	settingsFile.setValue(KEY_CUSTOM_ENCODER,  model->m_custom_encoder);
-	settingsFile.setValue(KEY_CUSTOM_AVS2YUV,  model->m_custom_avs2yuv);
-	
+	values.insert(KEY_ENCODER_TYPE,    model->m_encoderType);
+	values.insert(KEY_ENCODER_ARCH,    model->m_encoderArch);
+	values.insert(KEY_ENCODER_VARIANT, model->m_encoderVariant);
+	values.insert(KEY_RATECTRL_MODE,   model->m_rcMode);
+	values.insert(KEY_TARGET_BITRATE,  model->m_bitrate);
+	values.insert(KEY_TARGET_QUANT,    model->m_quantizer);
+	values.insert(KEY_PRESET_NAME,     model->m_preset);
+	values.insert(KEY_TUNING_NAME,     model->m_tune);
+	values.insert(KEY_PROFILE_NAME,    model->m_profile);
+	values.insert(KEY_CUSTOM_ENCODER,  model->m_custom_encoder);
+	values.insert(KEY_CUSTOM_AVS2YUV,  model->m_custom_avs2yuv);
+
 	return true;
 }
 
 bool OptionsModel::loadOptions(OptionsModel *model, QSettings &settingsFile)
 {
-	fixTemplate(settingsFile); /*for backward compatibility*/
+	QVariantMap values;
+	const QStringList keys = settingsFile.childKeys();
+
+	for(QStringList::ConstIterator iter = keys.constBegin(); iter != keys.constEnd(); iter++)
+	{
+		values.insert(*iter, settingsFile.value(*iter));
+	}
+
+	return loadOptions(model, values);
+}
+
+bool OptionsModel::loadOptions(OptionsModel *model, const QVariantMap &settings)
+{
+	QVariantMap values(settings);
+	fixTemplate(values); /*for backward compatibility*/
 	
 	bool complete = true;
-	if(!settingsFile.contains(KEY_ENCODER_TYPE))    complete = false;
-	if(!settingsFile.contains(KEY_ENCODER_ARCH))    complete = false;
-	if(!settingsFile.contains(KEY_ENCODER_VARIANT)) complete = false;
-	if(!settingsFile.contains(KEY_RATECTRL_MODE))   complete = false;
-	if(!settingsFile.contains(KEY_TARGET_BITRATE))  complete = false;
-	if(!settingsFile.contains(KEY_TARGET_QUANT))    complete = false;
-	if(!settingsFile.contains(KEY_PRESET_NAME))     complete = false;
-	if(!settingsFile.contains(KEY_TUNING_NAME))     complete = false;
-	if(!settingsFile.contains(KEY_PROFILE_NAME))    complete = false;
-	if(!settingsFile.contains(KEY_CUSTOM_ENCODER))  complete = false;
-	if(!settingsFile.contains(KEY_CUSTOM_AVS2YUV))  complete = false;
+	if(!values.contains(KEY_ENCODER_TYPE))    complete = false;
+	if(!values.contains(KEY_ENCODER_ARCH))    complete = false;
+	if(!values.contains(KEY_ENCODER_VARIANT)) complete = false;
+	if(!values.contains(KEY_RATECTRL_MODE))   complete = false;
+	if(!values.contains(KEY_TARGET_BITRATE))  complete = false;
+	if(!values.contains(KEY_TARGET_QUANT))    complete = false;
+	if(!values.contains(KEY_PRESET_NAME))     complete = false;
+	if(!values.contains(KEY_TUNING_NAME))     complete = false;
+	if(!values.contains(KEY_PROFILE_NAME))    complete = false;
+	if(!values.contains(KEY_CUSTOM_ENCODER))  complete = false;
+	if(!values.contains(KEY_CUSTOM_AVS2YUV))  complete = false;
 
 	if(complete)
 	{
-		model->setEncType        (settingsFile.value(KEY_ENCODER_TYPE,    model->m_encoderType)   .toInt());
-		model->setEncArch        (settingsFile.value(KEY_ENCODER_ARCH,    model->m_encoderArch)   .toInt());
-		model->setEncVariant     (settingsFile.value(KEY_ENCODER_VARIANT, model->m_encoderVariant).toInt());
-		model->setRCMode         (settingsFile.value(KEY_RATECTRL_MODE,   model->m_rcMode)        .toInt());
-		model->setBitrate        (settingsFile.value(KEY_TARGET_BITRATE,  model->m_bitrate)       .toUInt());
-		model->setQuantizer      (settingsFile.value(KEY_TARGET_QUANT,    model->m_quantizer)     .toDouble());
-		model->setPreset         (settingsFile.value(KEY_PRESET_NAME,     model->m_preset)        .toString());
-		model->setTune           (settingsFile.value(KEY_TUNING_NAME,     model->m_tune)          .toString());
-		model->setProfile        (settingsFile.value(KEY_PROFILE_NAME,    model->m_profile)       .toString());
-		model->setCustomEncParams(settingsFile.value(KEY_CUSTOM_ENCODER,  model->m_custom_encoder).toString());
-		model->setCustomAvs2YUV  (settingsFile.value(KEY_CUSTOM_AVS2YUV,  model->m_custom_avs2yuv).toString());
+		model->setEncType        (values.value(KEY_ENCODER_TYPE,    model->m_encoderType)   .toInt());
+		model->setEncArch        (values.value(KEY_ENCODER_ARCH,    model->m_encoderArch)   .toInt());
+		model->setEncVariant     (values.value(KEY_ENCODER_VARIANT, model->m_encoderVariant).toInt());
+		model->setRCMode         (values.value(KEY_RATECTRL_MODE,   model->m_rcMode)        .toInt());
+		model->setBitrate        (values.value(KEY_TARGET_BITRATE,  model->m_bitrate)       .toUInt());
+		model->setQuantizer      (values.value(KEY_TARGET_QUANT,    model->m_quantizer)     .toDouble());
+		model->setPreset         (values.value(KEY_PRESET_NAME,     model->m_preset)        .toString());
+		model->setTune           (values.value(KEY_TUNING_NAME,     model->m_tune)          .toString());
+		model->setProfile        (values.value(KEY_PROFILE_NAME,    model->m_profile)       .toString());
+		model->setCustomEncParams(values.value(KEY_CUSTOM_ENCODER,  model->m_custom_encoder).toString());
+		model->setCustomAvs2YUV  (values.value(KEY_CUSTOM_AVS2YUV,  model->m_custom_avs2yuv).toString());
 	}
 	
 	return complete;
 }
 
-void OptionsModel::fixTemplate(QSettings &settingsFile)
+void OptionsModel::fixTemplate(QVariantMap &values)
 {
-	if(!(settingsFile.contains(KEY_ENCODER_TYPE) || settingsFile.contains(KEY_ENCODER_ARCH) || settingsFile.contains(KEY_ENCODER_VARIANT)))
+	if(!(values.contains(KEY_ENCODER_TYPE) || values.contains(KEY_ENCODER_ARCH) || values.contains(KEY_ENCODER_VARIANT)))
 	{
-		settingsFile.setValue(KEY_ENCODER_TYPE,    0);
-		settingsFile.setValue(KEY_ENCODER_ARCH,    0);
-		settingsFile.setValue(KEY_ENCODER_VARIANT, 0);
+		values.insert(KEY_ENCODER_TYPE,    0);
+		values.insert(KEY_ENCODER_ARCH,    0);
+		values.insert(KEY_ENCODER_VARIANT, 0);
 	}
 
 	static const char *legacyKey[] = { "custom_params", "custom_params_x264", NULL };
 	for(int i = 0; legacyKey[i]; i++)
 	{
-		if(settingsFile.contains(legacyKey[i]))
+		if(values.contains(legacyKey[i]))
 		{
-			settingsFile.setValue(KEY_CUSTOM_ENCODER, settingsFile.value(legacyKey[i]));
-			settingsFile.remove(legacyKey[i]);
+			values.insert(KEY_CUSTOM_ENCODER, values.take(legacyKey[i]));
 		}
 	}
 
-	if(settingsFile.value(KEY_PROFILE_NAME).toString().compare("auto", Qt::CaseInsensitive) == 0)
+	if(values.value(KEY_PROFILE_NAME).toString().compare("auto", Qt::CaseInsensitive) == 0)
 	{
-		settingsFile.setValue(KEY_PROFILE_NAME, QString::fromLatin1(OptionsModel::PROFILE_UNRESTRICTED));
+		values.insert(KEY_PROFILE_NAME, QString::fromLatin1(OptionsModel::PROFILE_UNRESTRICTED));
 	}
-	if(settingsFile.value(KEY_TUNING_NAME).toString().compare("none", Qt::CaseInsensitive) == 0)
+	if(values.value(KEY_TUNING_NAME).toString().compare("none", Qt::CaseInsensitive) == 0)
 	{
-		settingsFile.setValue(KEY_TUNING_NAME, QString::fromLatin1(OptionsModel::SETTING_UNSPECIFIED));
+		values.insert(KEY_TUNING_NAME, QString::fromLatin1(OptionsModel::SETTING_UNSPECIFIED));
 	}
 }
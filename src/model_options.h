@@ -24,6 +24,7 @@
 #include <QObject>
 #include <QString>
 #include <QMap>
+#include <QVariant>
 
 class SysinfoModel;
 class QSettings;
@@ -86,6 +87,8 @@ public:
 	static bool deleteTemplate(const QString &name);
 	static bool saveOptions(const OptionsModel *model, QSettings &settingsFile);
 	static bool loadOptions(OptionsModel *model, QSettings &settingsFile);
+	static bool saveOptions(const OptionsModel *model, QVariantMap &values);
+	static bool loadOptions(OptionsModel *model, const QVariantMap &values);
 
 protected:
 	EncType m_encoderType;
@@ -101,5 +104,5 @@ protected:
 	QString m_custom_avs2yuv;
 
 private:
-	static void fixTemplate(QSettings &settingsFile);
+	static void fixTemplate(QVariantMap &values);
 };
@@ -75,6 +75,8 @@ void PreferencesModel::initPreferences(PreferencesModel *preferences)
 	INIT_VALUE(SaveLogFiles,       false);
 	INIT_VALUE(SaveToSourcePath,   false);
 	INIT_VALUE(ProcessPriority,    -1   );
+	INIT_VALUE(IoPriority,         0    );
+	INIT_VALUE(IoBandwidthLimit,   0    );
 	INIT_VALUE(EnableSounds,       false);
 	INIT_VALUE(DisableWarnings,    false);
 	INIT_VALUE(NoUpdateReminder,   false);
@@ -82,6 +84,15 @@ void PreferencesModel::initPreferences(PreferencesModel *preferences)
 	INIT_VALUE(SkipVersionTest,    false);
 	INIT_VALUE(NoSystrayWarning,   false);
 	INIT_VALUE(SaveQueueNoConfirm, false);
+	INIT_VALUE(KeepJobsAlive,      false);
+	INIT_VALUE(RenderAheadJobs,    0    );
+	INIT_VALUE(RenderAheadSpool,   2048 );
+	INIT_VALUE(StageInputJobs,     0    );
+	INIT_VALUE(StageInputBudget,   32   );
+	INIT_VALUE(StageOutput,        false);
+	INIT_VALUE(SaveChecksums,      false);
+	INIT_VALUE(ArchiveJobsAge,     0    );
+	INIT_VALUE(ArchiveJobsCount,   0    );
 }
 
 void PreferencesModel::loadPreferences(PreferencesModel *preferences)
@@ -97,15 +108,34 @@ void PreferencesModel::loadPreferences(PreferencesModel *preferences)
 	LOAD_VALUE_B(SaveLogFiles      );
 	LOAD_VALUE_B(SaveToSourcePath  );
 	LOAD_VALUE_I(ProcessPriority   );
+	LOAD_VALUE_I(IoPriority        );
+	LOAD_VALUE_U(IoBandwidthLimit  );
 	LOAD_VALUE_B(EnableSounds      );
 	LOAD_VALUE_B(DisableWarnings   );
 	LOAD_VALUE_B(NoUpdateReminder  );
 	LOAD_VALUE_B(NoSystrayWarning  );
 	LOAD_VALUE_B(SaveQueueNoConfirm);
+	LOAD_VALUE_B(KeepJobsAlive     );
+	LOAD_VALUE_U(RenderAheadJobs   );
+	LOAD_VALUE_U(RenderAheadSpool  );
+	LOAD_VALUE_U(StageInputJobs    );
+	LOAD_VALUE_U(StageInputBudget  );
+	LOAD_VALUE_B(StageOutput       );
+	LOAD_VALUE_B(SaveChecksums     );
+	LOAD_VALUE_U(ArchiveJobsAge    );
+	LOAD_VALUE_U(ArchiveJobsCount  );
 
 	//Validation
 	preferences->setProcessPriority(qBound(-2, preferences->getProcessPriority(), 2));
 	preferences->setMaxRunningJobCount(qBound(1U, preferences->getMaxRunningJobCount(), 16U));
+	preferences->setIoPriority(qBound(-2, preferences->getIoPriority(), 0));
+	preferences->setIoBandwidthLimit(qMin(preferences->getIoBandwidthLimit(), 4096U));
+	preferences->setRenderAheadJobs(qMin(preferences->getRenderAheadJobs(), 4U));
+	preferences->setRenderAheadSpool(qBound(64U, preferences->getRenderAheadSpool(), 65536U));
+	preferences->setStageInputJobs(qMin(preferences->getStageInputJobs(), 4U));
+	preferences->setStageInputBudget(qBound(1U, preferences->getStageInputBudget(), 1024U));
+	preferences->setArchiveJobsAge(qMin(preferences->getArchiveJobsAge(), 10080U));
+	preferences->setArchiveJobsCount(qMin(preferences->getArchiveJobsCount(), 10000U));
 }
 
 void PreferencesModel::savePreferences(PreferencesModel *preferences)
@@ -120,11 +150,22 @@ void PreferencesModel::savePreferences(PreferencesModel *preferences)
 	STORE_VALUE(SaveLogFiles      );
 	STORE_VALUE(SaveToSourcePath  );
 	STORE_VALUE(ProcessPriority   );
+	STORE_VALUE(IoPriority        );
+	STORE_VALUE(IoBandwidthLimit  );
 	STORE_VALUE(EnableSounds      );
 	STORE_VALUE(DisableWarnings   );
 	STORE_VALUE(NoUpdateReminder  );
 	STORE_VALUE(NoSystrayWarning  );
 	STORE_VALUE(SaveQueueNoConfirm);
+	STORE_VALUE(KeepJobsAlive     );
+	STORE_VALUE(RenderAheadJobs   );
+	STORE_VALUE(RenderAheadSpool  );
+	STORE_VALUE(StageInputJobs    );
+	STORE_VALUE(StageInputBudget  );
+	STORE_VALUE(StageOutput       );
+	STORE_VALUE(SaveChecksums     );
+	STORE_VALUE(ArchiveJobsAge    );
+	STORE_VALUE(ArchiveJobsCount  );
 	
 	settings.sync();
 }
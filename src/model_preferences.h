@@ -59,6 +59,8 @@ public:
 	PREFERENCES_MAKE_B(SaveLogFiles)
 	PREFERENCES_MAKE_B(SaveToSourcePath)
 	PREFERENCES_MAKE_I(ProcessPriority)
+	PREFERENCES_MAKE_I(IoPriority)
+	PREFERENCES_MAKE_U(IoBandwidthLimit)
 	PREFERENCES_MAKE_B(EnableSounds)
 	PREFERENCES_MAKE_B(DisableWarnings)
 	PREFERENCES_MAKE_B(NoUpdateReminder)
@@ -66,6 +68,15 @@ public:
 	PREFERENCES_MAKE_B(SkipVersionTest)
 	PREFERENCES_MAKE_B(NoSystrayWarning)
 	PREFERENCES_MAKE_B(SaveQueueNoConfirm)
+	PREFERENCES_MAKE_B(KeepJobsAlive)
+	PREFERENCES_MAKE_U(RenderAheadJobs)
+	PREFERENCES_MAKE_U(RenderAheadSpool)
+	PREFERENCES_MAKE_U(StageInputJobs)
+	PREFERENCES_MAKE_U(StageInputBudget)
+	PREFERENCES_MAKE_B(StageOutput)
+	PREFERENCES_MAKE_B(SaveChecksums)
+	PREFERENCES_MAKE_U(ArchiveJobsAge)
+	PREFERENCES_MAKE_U(ArchiveJobsCount)
 
 public:
 	static void initPreferences(PreferencesModel *preferences);
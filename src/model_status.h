@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <QtGlobal>
+
 enum JobStatus
 {
 	JobStatus_Enqueued = 0,
@@ -36,5 +38,25 @@ enum JobStatus
 	JobStatus_Resuming = 10,
 	JobStatus_Aborting = 11,
 	JobStatus_Aborted = 12,
+	JobStatus_Finalizing = 13,
 	JobStatus_Undefined = 666
 };
+
+struct JobStatistics
+{
+	JobStatistics(void)
+	:
+		userTime(0), kernelTime(0), peakWorkingSet(0), peakCommitted(0), readBytes(0), writeBytes(0), readOperations(0), writeOperations(0), processCount(0)
+	{
+	}
+
+	quint64 userTime;         //total user-mode CPU time, in milliseconds
+	quint64 kernelTime;       //total kernel-mode CPU time, in milliseconds
+	quint64 peakWorkingSet;   //peak resident memory of all processes combined (sampled), in bytes
+	quint64 peakCommitted;    //peak committed memory of the whole job, in bytes
+	quint64 readBytes;        //total number of bytes read
+	quint64 writeBytes;       //total number of bytes written
+	quint64 readOperations;   //total number of read operations
+	quint64 writeOperations;  //total number of write operations
+	quint32 processCount;     //total number of processes that have been spawned
+};
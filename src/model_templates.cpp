@@ -0,0 +1,249 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "model_templates.h"
+
+#include "global.h"
+
+#include <QFile>
+#include <QSettings>
+#include <QUuid>
+
+static const char *KEY_INHERITS = "inherits";
+
+QMutex                      TemplateRegistry::s_mutex;
+bool                        TemplateRegistry::s_loaded = false;
+QString                     TemplateRegistry::s_identity;
+QMap<QString, TemplateRegistry::entry_t> TemplateRegistry::s_entries;
+QHash<QString, QVariantMap> TemplateRegistry::s_resolved;
+
+///////////////////////////////////////////////////////////////////////////////
+// Public Functions
+///////////////////////////////////////////////////////////////////////////////
+
+QStringList TemplateRegistry::names(void)
+{
+	QMutexLocker lock(&s_mutex);
+	reload();
+
+	QStringList list;
+	for(QMap<QString, entry_t>::ConstIterator iter = s_entries.constBegin(); iter != s_entries.constEnd(); iter++)
+	{
+		list << iter->name;
+	}
+	return list;
+}
+
+bool TemplateRegistry::contains(const QString &name)
+{
+	QMutexLocker lock(&s_mutex);
+	reload();
+	return s_entries.contains(name.toLower());
+}
+
+bool TemplateRegistry::get(const QString &name, QVariantMap &values)
+{
+	QMutexLocker lock(&s_mutex);
+	reload();
+	return resolve(name.toLower(), values, 0);
+}
+
+bool TemplateRegistry::put(const QString &name, const QVariantMap &values)
+{
+	QMutexLocker lock(&s_mutex);
+	reload();
+
+	const QString key = name.toLower();
+	entry_t entry;
+	entry.name = name;
+	entry.values = values;
+
+	//Derived templates only keep the values that differ from their parent
+	if(s_entries.contains(key))
+	{
+		const entry_t &previous = s_entries[key];
+		QVariantMap parentValues;
+		if((!previous.parent.isEmpty()) && resolve(previous.parent.toLower(), parentValues, 1))
+		{
+			for(QVariantMap::ConstIterator iter = parentValues.constBegin(); iter != parentValues.constEnd(); iter++)
+			{
+				if(entry.values.contains(iter.key()) && (entry.values[iter.key()].toString() == iter->toString()))
+				{
+					entry.values.remove(iter.key());
+				}
+			}
+			entry.parent = previous.parent;
+		}
+		entry.name = previous.name;
+	}
+
+	s_entries.insert(key, entry);
+	s_resolved.clear();
+	return writeBack();
+}
+
+bool TemplateRegistry::remove(const QString &name)
+{
+	QMutexLocker lock(&s_mutex);
+	reload();
+
+	const QString key = name.toLower();
+	if(!s_entries.contains(key))
+	{
+		return false;
+	}
+
+	//Flatten the templates that inherit from the removed one
+	for(QMap<QString, entry_t>::Iterator iter = s_entries.begin(); iter != s_entries.end(); iter++)
+	{
+		if(iter->parent.compare(key, Qt::CaseInsensitive) == 0)
+		{
+			QVariantMap values;
+			if(resolve(iter.key(), values, 0))
+			{
+				iter->values = values;
+			}
+			iter->parent.clear();
+		}
+	}
+
+	s_entries.remove(key);
+	s_resolved.clear();
+	return writeBack();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Internal Functions
+///////////////////////////////////////////////////////////////////////////////
+
+void TemplateRegistry::reload(void)
+{
+	const QString fileName = getFileName();
+	const QString identity = x264_file_identity(fileName);
+
+	if(s_loaded && (identity.compare(s_identity) == 0))
+	{
+		return; /*file has not been modified*/
+	}
+
+	s_entries.clear();
+	s_resolved.clear();
+
+	QSettings settings(fileName, QSettings::IniFormat);
+	const QStringList groups = settings.childGroups();
+	for(QStringList::ConstIterator iter = groups.constBegin(); iter != groups.constEnd(); iter++)
+	{
+		entry_t entry;
+		entry.name = *iter;
+		settings.beginGroup(*iter);
+		const QStringList keys = settings.childKeys();
+		for(QStringList::ConstIterator key = keys.constBegin(); key != keys.constEnd(); key++)
+		{
+			entry.values.insert(*key, settings.value(*key));
+		}
+		settings.endGroup();
+		entry.parent = entry.values.take(KEY_INHERITS).toString().trimmed();
+		s_entries.insert(entry.name.toLower(), entry);
+	}
+
+	s_identity = identity;
+	s_loaded = true;
+}
+
+bool TemplateRegistry::resolve(const QString &key, QVariantMap &values, const int depth)
+{
+	if(s_resolved.contains(key))
+	{
+		values = s_resolved[key];
+		return true;
+	}
+
+	if((!s_entries.contains(key)) || (depth > MAX_DEPTH))
+	{
+		return false; /*unknown template or inheritance cycle*/
+	}
+
+	const entry_t &entry = s_entries[key];
+	QVariantMap resolved;
+	if((!entry.parent.isEmpty()) && (!resolve(entry.parent.toLower(), resolved, depth + 1)))
+	{
+		qWarning("Template \"%s\" inherits from unknown template \"%s\"", entry.name.toUtf8().constData(), entry.parent.toUtf8().constData());
+		return false;
+	}
+
+	for(QVariantMap::ConstIterator iter = entry.values.constBegin(); iter != entry.values.constEnd(); iter++)
+	{
+		resolved.insert(iter.key(), iter.value());
+	}
+
+	s_resolved.insert(key, resolved);
+	values = resolved;
+	return true;
+}
+
+bool TemplateRegistry::writeBack(void)
+{
+	const QString fileName = getFileName();
+	const QString tempName = QString("%1/~templates_%2.tmp").arg(x264_data_path(), QUuid::createUuid().toString().mid(1, 36));
+
+	//Write all templates to a temporary file first
+	{
+		QSettings settings(tempName, QSettings::IniFormat);
+		settings.clear();
+		for(QMap<QString, entry_t>::ConstIterator iter = s_entries.constBegin(); iter != s_entries.constEnd(); iter++)
+		{
+			settings.beginGroup(iter->name);
+			for(QVariantMap::ConstIterator value = iter->values.constBegin(); value != iter->values.constEnd(); value++)
+			{
+				settings.setValue(value.key(), value.value());
+			}
+			if(!iter->parent.isEmpty())
+			{
+				settings.setValue(KEY_INHERITS, iter->parent);
+			}
+			settings.endGroup();
+		}
+		settings.sync();
+		if(settings.status() != QSettings::NoError)
+		{
+			qWarning("Failed to write templates: %s", tempName.toUtf8().constData());
+			QFile::remove(tempName);
+			return false;
+		}
+	}
+
+	//Now replace the original file in a single step
+	if(!x264_replace_file(tempName, fileName))
+	{
+		qWarning("Failed to replace templates: %s", fileName.toUtf8().constData());
+		QFile::remove(tempName);
+		return false;
+	}
+
+	s_identity = x264_file_identity(fileName);
+	return true;
+}
+
+QString TemplateRegistry::getFileName(void)
+{
+	return QString("%1/templates.ini").arg(x264_data_path());
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QMap>
+#include <QHash>
+#include <QMutex>
+
+class TemplateRegistry
+{
+public:
+	static QStringList names(void);
+	static bool contains(const QString &name);
+	static bool get(const QString &name, QVariantMap &values);
+	static bool put(const QString &name, const QVariantMap &values);
+	static bool remove(const QString &name);
+
+protected:
+	typedef struct
+	{
+		QString name;
+		QString parent;
+		QVariantMap values;
+	}
+	entry_t;
+
+	static const int MAX_DEPTH = 16;
+
+	static void reload(void);
+	static bool resolve(const QString &key, QVariantMap &values, const int depth);
+	static bool writeBack(void);
+	static QString getFileName(void);
+
+	static QMutex s_mutex;
+	static bool s_loaded;
+	static QString s_identity;
+	static QMap<QString, entry_t> s_entries;
+	static QHash<QString, QVariantMap> s_resolved;
+};
@@ -199,6 +199,14 @@ bool AbstractSource::createProcess(QProcess &processEncode, QProcess&processInpu
 	return true;
 }
 
+void AbstractSource::getRenderCommand(QString &program, QStringList &cmdLine, QStringList &extraPaths, QHash<QString, QString> &extraEnv)
+{
+	program = getBinaryPath();
+	buildCommandLine(cmdLine);
+	extraPaths = getExtraPaths();
+	extraEnv = getExtraEnv();
+}
+
 // ------------------------------------------------------------
 // Source Info
 // ------------------------------------------------------------
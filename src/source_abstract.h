@@ -45,6 +45,7 @@ public:
 	virtual bool isSourceAvailable(void) = 0;
 	virtual bool checkSourceProperties(ClipInfo &clipInfo);
 	virtual bool createProcess(QProcess &processEncode, QProcess&processInput);
+	virtual void getRenderCommand(QString &program, QStringList &cmdLine, QStringList &extraPaths, QHash<QString, QString> &extraEnv);
 	virtual void flushProcess(QProcess &processInput) = 0;
 
 	static const AbstractSourceInfo& getSourceInfo(void);
@@ -25,6 +25,8 @@
 #include "model_sysinfo.h"
 #include "model_preferences.h"
 
+#include <QFileInfo>
+
 class VapoursynthSource : public AbstractSource
 {
 public:
@@ -49,5 +51,6 @@ protected:
 	virtual void checkSourceProperties_parseLine(const QString &line, const QList<QRegExp*> &patterns, ClipInfo &clipInfo);
 
 	virtual QString getBinaryPath() const { return getSourceInfo().getBinaryPath(m_sysinfo, m_sysinfo->getCPUFeatures(SysinfoModel::CPUFeatures_X64) && m_sysinfo->getVapourSynth(SysinfoModel::VapourSynth_X64) && (m_preferences->getPrefer64BitSource() || (!m_sysinfo->getVapourSynth(SysinfoModel::VapourSynth_X86)))); }
+	virtual QStringList getVersionDependencies(void) const { return QStringList() << QString("%1/VSScript.dll").arg(QFileInfo(getBinaryPath()).absolutePath()); }
 	virtual void buildCommandLine(QStringList &cmdLine);
 };
@@ -21,6 +21,9 @@
 
 #include "string_validator.h"
 
+//Internal
+#include "encoder_schema.h"
+
 ///////////////////////////////////////////////////////////////////////////////
 // StringValidator
 ///////////////////////////////////////////////////////////////////////////////
@@ -174,7 +177,37 @@ QValidator::State StringValidatorEncoder::validate(QString &input, int &pos) con
 	const QStringList tokens =  commandLine.isEmpty() ? QStringList() : MUtils::OS::crack_command_line(commandLine);
 
 	const bool invalid = checkCharacters(tokens) || checkPrefix(tokens, true) || checkParam(tokens, params, true);
-	return setStatus(invalid, "encoder") ? QValidator::Intermediate : QValidator::Acceptable;
+	if(setStatus(invalid, "encoder"))
+	{
+		return QValidator::Intermediate;
+	}
+
+	checkSchema(tokens);
+	return QValidator::Acceptable;
+}
+
+/*
+ * The schema is parsed from the encoder's help text and may be incomplete, so a mismatch only shows a warning
+ */
+bool StringValidatorEncoder::checkSchema(const QStringList &input) const
+{
+	if(m_schema.isNull())
+	{
+		return false; /*schema not available (yet)*/
+	}
+
+	QString error;
+	if(!m_schema->validate(input, error))
+	{
+		if(m_notifier)
+		{
+			m_notifier->setText(tr("Warning: %1").arg(error));
+			if(m_notifier->isHidden()) m_notifier->show();
+			if(m_icon) { if(m_icon->isHidden()) m_icon->show(); }
+		}
+		return true;
+	}
+	return false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,9 @@
 #include <QValidator>
 #include <QLabel>
 #include <QToolTip>
+#include <QSharedPointer>
+
+class EncoderSchema;
 
 class StringValidator : public QValidator
 {
@@ -50,6 +53,13 @@ class StringValidatorEncoder : public StringValidator
 public:
 	StringValidatorEncoder(QLabel *notifier, QLabel *icon) : StringValidator(notifier, icon) {}
 	virtual State validate(QString &input, int &pos) const;
+
+	void setSchema(const QSharedPointer<const EncoderSchema> &schema) { m_schema = schema; }
+
+protected:
+	bool checkSchema(const QStringList &input) const;
+
+	QSharedPointer<const EncoderSchema> m_schema;
 };
 
 class StringValidatorSource : public StringValidator
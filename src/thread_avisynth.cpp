@@ -86,24 +86,12 @@ bool AvisynthCheckThread::detect(SysinfoModel *sysinfo)
 	double version = 0.0;
 	QMutexLocker lock(&m_avsLock);
 
-	QEventLoop loop;
 	AvisynthCheckThread thread(sysinfo);
 
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-
-	connect(&thread, SIGNAL(finished()), &loop, SLOT(quit()));
-	connect(&thread, SIGNAL(terminated()), &loop, SLOT(quit()));
-	
 	thread.start();
-	QTimer::singleShot(30000, &loop, SLOT(quit()));
-	
 	qDebug("Avisynth thread has been created, please wait...");
-	loop.exec(QEventLoop::ExcludeUserInputEvents);
-	qDebug("Avisynth thread finished.");
 
-	QApplication::restoreOverrideCursor();
-
-	if(!thread.wait(1000))
+	if(!thread.wait(30000))
 	{
 		qWarning("Avisynth thread encountered timeout -> probably deadlock!");
 		thread.terminate();
@@ -217,14 +205,31 @@ bool AvisynthCheckThread::checkAvisynth(QString &basePath, const SysinfoModel *c
 	}
 
 	//Get extra paths
-	QStringList avisynthExtraPaths;
+	QStringList avisynthExtraPaths, probeFiles;
+	probeFiles << AVS_CHECK_BINARY(sysinfo, x64);
 	if (!basePath.isEmpty())
 	{
 		avisynthExtraPaths << QString("%1/%2").arg(basePath, archSuffix);
+		probeFiles << QString("%1/%2/avisynth.dll").arg(basePath, archSuffix);
+	}
+
+	//Re-use the previous result, if none of the involved files has changed
+	QStringList output;
+	bool cached = false;
+	{
+		Wow64RedirectionDisabler disableWow64Redir;
+		cached = lookupProbe(probeFiles, output);
 	}
 
 	//Setup process object
-	const QStringList output = runProcess(AVS_CHECK_BINARY(sysinfo, x64), QStringList(), &avisynthExtraPaths);
+	if (cached)
+	{
+		qDebug("Using cached Avisynth %s-Bit check result.", x64 ? "64" : "32");
+	}
+	else
+	{
+		output = runProcess(AVS_CHECK_BINARY(sysinfo, x64), QStringList(), &avisynthExtraPaths);
+	}
 
 	//Init regular expressions
 	QRegExp avsLogo("Avisynth\\s+Checker\\s+(x86|x64)");
@@ -265,11 +270,19 @@ bool AvisynthCheckThread::checkAvisynth(QString &basePath, const SysinfoModel *c
 	//Minimum required version found?
 	if((avisynthVersion[0] >= 2) && (avisynthVersion[1] >= 50) && (!avisynthPath.isEmpty()))
 	{
-		Wow64RedirectionDisabler disableWow64Redir;
-		path = new QFile(avisynthPath);
-		if(!path->open(QIODevice::ReadOnly))
 		{
-			MUTILS_DELETE(path);
+			Wow64RedirectionDisabler disableWow64Redir;
+			path = new QFile(avisynthPath);
+			if(!path->open(QIODevice::ReadOnly))
+			{
+				MUTILS_DELETE(path);
+			}
+		}
+		if(!cached)
+		{
+			//The identities must be taken with redirection disabled, exactly like in lookupProbe()
+			Wow64RedirectionDisabler disableWow64Redir;
+			storeProbe(probeFiles, output, QStringList() << avisynthPath);
 		}
 		qDebug("Avisynth was detected successfully (current version: %u.%02u).", avisynthVersion[0], avisynthVersion[1]);
 		qDebug("Avisynth DLL path: %s", MUTILS_UTF8(avisynthPath));
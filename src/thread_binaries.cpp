@@ -29,6 +29,7 @@
 #include <QApplication>
 #include <QProcess>
 #include <QDir>
+#include <QtConcurrentMap>
 
 //Internal
 #include "global.h"
@@ -36,6 +37,7 @@
 #include "win_updater.h"
 #include "encoder_factory.h"
 #include "source_factory.h"
+#include "cache_digest.h"
 
 //MUtils
 #include <MUtils/Global.h>
@@ -61,24 +63,12 @@ bool BinariesCheckThread::check(const SysinfoModel *const sysinfo, QString *cons
 {
 	QMutexLocker lock(&m_binLock);
 
-	QEventLoop loop;
 	BinariesCheckThread thread(sysinfo);
 
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-
-	connect(&thread, SIGNAL(finished()),   &loop, SLOT(quit()));
-	connect(&thread, SIGNAL(terminated()), &loop, SLOT(quit()));
-	
 	thread.start();
-	QTimer::singleShot(30000, &loop, SLOT(quit()));
-	
 	qDebug("Binaries checker thread has been created, please wait...");
-	loop.exec(QEventLoop::ExcludeUserInputEvents);
-	qDebug("Binaries checker thread finished.");
 
-	QApplication::restoreOverrideCursor();
-
-	if(!thread.wait(5000))
+	if(!thread.wait(30000))
 	{
 		qWarning("Binaries checker thread encountered timeout -> probably deadlock!");
 		thread.terminate();
@@ -125,7 +115,6 @@ void BinariesCheckThread::run(void)
 int BinariesCheckThread::threadMain(void)
 {
 	//Create list of all required binary files
-	typedef QPair<QString, bool> FileEntry;
 	QList<FileEntry> binFiles;
 	for(OptionsModel::EncType encdr = OptionsModel::EncType_MIN; encdr <= OptionsModel::EncType_MAX; NEXT(encdr))
 	{
@@ -168,47 +157,76 @@ int BinariesCheckThread::threadMain(void)
 		}
 	}
 
-	//Actually validate the binaries
-	size_t currentFile = 0;
-	for(QList<FileEntry>::ConstIterator iter = binFiles.constBegin(); iter != binFiles.constEnd(); iter++)
+	//Actually validate the binaries, all files are locked and verified in parallel
+	const QList<QFile*> files = QtConcurrent::blockingMapped<QList<QFile*> >(binFiles, verifyBinary);
+	bool success = true;
+	for(int i = 0; i < files.count(); i++)
+	{
+		if(!files[i])
+		{
+			m_failedPath = binFiles[i].first;
+			success = false;
+			break;
+		}
+	}
+	if(!success)
+	{
+		qDeleteAll(files);
+		return 0;
+	}
+
+	if(size_t(files.count()) > MAX_BINARIES)
+	{
+		qFatal("Current binary file exceeds max. number of binaries!");
+	}
+	for(int i = 0; i < files.count(); i++)
+	{
+		m_binPath[i].reset(files[i]);
+	}
+
+	return 1;
+}
+
+//-------------------------------------
+// Internal functions
+//-------------------------------------
+
+QFile *BinariesCheckThread::verifyBinary(const FileEntry &entry)
+{
+	QScopedPointer<QFile> file(new QFile(entry.first));
+	qDebug("%s", MUTILS_UTF8(file->fileName()));
+
+	if(!file->open(QIODevice::ReadOnly))
+	{
+		qWarning("Required tool could not be found or access denied:\n%s\n", MUTILS_UTF8(file->fileName()));
+		return NULL;
+	}
+
+	//Skip the image check, if this very file has been verified before (file is locked now)
+	const QByteArray imageType(entry.second ? "dll" : "exe");
+	QByteArray cachedType;
+	if(DigestCache::lookup(file->fileName(), "pe_image", cachedType) && (cachedType == imageType))
 	{
-		QScopedPointer<QFile> file(new QFile(iter->first));
-		qDebug("%s", MUTILS_UTF8(file->fileName()));
+		return file.take();
+	}
 
-		if(file->open(QIODevice::ReadOnly))
+	if(!entry.second)
+	{
+		if (!MUtils::OS::is_executable_file(file->fileName()))
 		{
-			if(!iter->second)
-			{
-				if (!MUtils::OS::is_executable_file(file->fileName()))
-				{
-					m_failedPath = file->fileName();
-					qWarning("Required tool does NOT look like a valid Win32/Win64 binary:\n%s\n", MUTILS_UTF8(file->fileName()));
-					return 0;
-				}
-			}
-			else
-			{
-				if (!MUtils::OS::is_library_file(file->fileName()))
-				{
-					m_failedPath = file->fileName();
-					qWarning("Required tool does NOT look like a valid Win32/Win64 library:\n%s\n", MUTILS_UTF8(file->fileName()));
-					return 0;
-				}
-			}
-			if(currentFile < MAX_BINARIES)
-			{
-				m_binPath[currentFile++].reset(file.take());
-				continue;
-			}
-			qFatal("Current binary file exceeds max. number of binaries!");
+			qWarning("Required tool does NOT look like a valid Win32/Win64 binary:\n%s\n", MUTILS_UTF8(file->fileName()));
+			return NULL;
 		}
-		else
+	}
+	else
+	{
+		if (!MUtils::OS::is_library_file(file->fileName()))
 		{
-			m_failedPath = file->fileName();
-			qWarning("Required tool could not be found or access denied:\n%s\n", MUTILS_UTF8(file->fileName()));
-			return 0;
+			qWarning("Required tool does NOT look like a valid Win32/Win64 library:\n%s\n", MUTILS_UTF8(file->fileName()));
+			return NULL;
 		}
 	}
 
-	return 1;
+	DigestCache::store(file->fileName(), "pe_image", imageType);
+	return file.take();
 }
@@ -25,6 +25,7 @@
 
 //Qt
 #include <QMutex>
+#include <QPair>
 
 class QLibrary;
 class SysinfoModel;
@@ -43,6 +44,8 @@ protected:
 	
 	const QString& getFailedPath(void) { return m_failedPath; }
 
+	typedef QPair<QString, bool> FileEntry;
+
 private:
 	QString m_failedPath;
 	const SysinfoModel *const m_sysinfo;
@@ -56,4 +59,7 @@ private:
 
 	//Thread main
 	virtual int threadMain(void);
+
+	//Internal functions
+	static QFile *verifyBinary(const FileEntry &entry);
 };
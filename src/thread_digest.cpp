@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_digest.h"
+
+//Internal
+#include "global.h"
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/Hash.h>
+
+//Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QScopedPointer>
+
+static const char *GRP_MANIFEST  = "manifest";
+static const char *GRP_BLOCKS    = "blocks";
+static const char *KEY_FILE      = "file";
+static const char *KEY_SIZE      = "size";
+static const char *KEY_ALGORITHM = "algorithm";
+static const char *KEY_BLOCKSIZE = "block_size";
+static const char *KEY_DIGEST    = "digest";
+
+//Containers whose muxers (as used by the encoders) only patch the header when finishing the file, apart from appending
+static const char *const HEADER_PATCH_ONLY[] = { "mkv", "mp4", "flv", "264", "h264", "265", "h265", "hevc", NULL };
+
+////////////////////////////////////////////////////////////
+// Constructor & Destructor
+////////////////////////////////////////////////////////////
+
+DigestThread::DigestThread(const QString &fileName)
+:
+	m_fileName(fileName),
+	m_fileSize(0)
+{
+	m_stopFlag = false;
+}
+
+DigestThread::~DigestThread(void)
+{
+}
+
+////////////////////////////////////////////////////////////
+// Public Methods
+////////////////////////////////////////////////////////////
+
+void DigestThread::stop(void)
+{
+	QMutexLocker lock(&m_mutex);
+	m_stopFlag = true;
+	m_stopped.wakeAll();
+}
+
+bool DigestThread::complete(volatile bool *abort)
+{
+	if(isRunning())
+	{
+		return false;
+	}
+
+	QFile file(m_fileName);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	//Drop the blocks that are beyond the end of the file now
+	if(!hashBlocks(file, 0, abort))
+	{
+		return false;
+	}
+
+	/*
+	 * Blocks hashed by the thread were complete when read, as the encoder writes sequentially and the thread stays one
+	 * block behind. When finishing the file, the muxers of the supported containers only append data (hashed below as
+	 * the tail) and patch a few fields in the header (sizes, duration), which is always in block #0. The only other
+	 * change is relocating the index to the front (MP4 "fast start"), which shifts *all* data behind it: This is
+	 * detected by comparing a sample of each block, as shifted data matching at every sampled offset is negligible.
+	 * Unknown containers may patch anywhere, so all of their blocks are hashed again.
+	 */
+	bool unchanged = isPatchedInHeaderOnly(m_fileName);
+	if(unchanged && (!checkSamples(file, abort, unchanged)))
+	{
+		return false;
+	}
+	for(int i = 0; i < m_blocks.count(); i++)
+	{
+		if(abort && (*abort))
+		{
+			return false;
+		}
+		if((i == 0) || (!unchanged) || m_blocks.at(i).digest.isEmpty())
+		{
+			if(!hashBlock(file, i, m_blocks[i]))
+			{
+				return false;
+			}
+		}
+	}
+
+	//Hash the tail, which has not been hashed by the thread yet
+	if(m_blocks.isEmpty() || (!hashBlocks(file, file.size(), abort)))
+	{
+		return false;
+	}
+
+	QScopedPointer<MUtils::Hash::Hash> digest(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+	for(QList<block_t>::ConstIterator iter = m_blocks.constBegin(); iter != m_blocks.constEnd(); iter++)
+	{
+		digest->update(iter->digest);
+	}
+
+	m_fileSize = file.size();
+	m_digest = digest->digest();
+	return true;
+}
+
+bool DigestThread::writeManifest(const QString &outputFile) const
+{
+	if(m_digest.isEmpty())
+	{
+		return false;
+	}
+
+	const QString manifestFile = QString("%1.manifest").arg(outputFile);
+	QFile::remove(manifestFile);
+
+	QSettings manifest(manifestFile, QSettings::IniFormat);
+	manifest.beginGroup(GRP_MANIFEST);
+	manifest.setValue(KEY_FILE,      QFileInfo(outputFile).fileName());
+	manifest.setValue(KEY_SIZE,      m_fileSize);
+	manifest.setValue(KEY_ALGORITHM, QString("BLAKE2-512 (hash list)"));
+	manifest.setValue(KEY_BLOCKSIZE, BLOCK_SIZE);
+	manifest.setValue(KEY_DIGEST,    QString::fromLatin1(m_digest));
+	manifest.endGroup();
+
+	manifest.beginWriteArray(GRP_BLOCKS, m_blocks.count());
+	for(int i = 0; i < m_blocks.count(); i++)
+	{
+		manifest.setArrayIndex(i);
+		manifest.setValue(KEY_DIGEST, QString::fromLatin1(m_blocks[i].digest));
+	}
+	manifest.endArray();
+
+	manifest.sync();
+	return (manifest.status() == QSettings::NoError);
+}
+
+////////////////////////////////////////////////////////////
+// Thread Main
+////////////////////////////////////////////////////////////
+
+void DigestThread::run(void)
+{
+	setTerminationEnabled(true);
+	AbstractThread::run();
+}
+
+int DigestThread::threadMain(void)
+{
+	forever
+	{
+		{
+			QMutexLocker lock(&m_mutex);
+			if(!m_stopFlag)
+			{
+				m_stopped.wait(&m_mutex, POLL_INTERVAL);
+			}
+			if(m_stopFlag)
+			{
+				break;
+			}
+		}
+
+		//Stay one block behind the encoder, recently written data may still be patched by the muxer
+		QFile file(m_fileName);
+		if(file.open(QIODevice::ReadOnly))
+		{
+			hashBlocks(file, file.size() - BLOCK_SIZE, &m_stopFlag);
+		}
+	}
+
+	return 1;
+}
+
+////////////////////////////////////////////////////////////
+// Hashing
+////////////////////////////////////////////////////////////
+
+bool DigestThread::hashBlocks(QFile &file, const qint64 &limit, volatile bool *abort)
+{
+	//File was truncated, e.g. encoder restarted, so resume from the last offset that is still valid
+	const int validBlocks = int(file.size() / qint64(BLOCK_SIZE));
+	while(m_blocks.count() > validBlocks)
+	{
+		m_blocks.removeLast();
+	}
+
+	//Block #0 contains the header, which is rewritten by most muxers when finishing the file
+	if(m_blocks.isEmpty())
+	{
+		m_blocks.append(block_t());
+	}
+
+	while((qint64(m_blocks.count()) * BLOCK_SIZE) < limit)
+	{
+		if(abort && (*abort))
+		{
+			return false;
+		}
+		block_t block;
+		if(!hashBlock(file, m_blocks.count(), block))
+		{
+			return false;
+		}
+		m_blocks.append(block);
+	}
+
+	return true;
+}
+
+bool DigestThread::hashBlock(QFile &file, const int &index, block_t &block)
+{
+	if(!file.seek(qint64(index) * BLOCK_SIZE))
+	{
+		return false;
+	}
+
+	const QByteArray data = file.read(BLOCK_SIZE);
+	if((data.size() < BLOCK_SIZE) && (!file.atEnd()))
+	{
+		return false;
+	}
+
+	QScopedPointer<MUtils::Hash::Hash> digest(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+	digest->update(data);
+	block.digest = digest->digest();
+	block.sample = data.left(SAMPLE_SIZE);
+	return true;
+}
+
+bool DigestThread::checkSamples(QFile &file, volatile bool *abort, bool &unchanged)
+{
+	unchanged = true;
+	for(int i = 1; (i < m_blocks.count()) && unchanged; i++)
+	{
+		if(abort && (*abort))
+		{
+			return false;
+		}
+		const block_t &block = m_blocks.at(i);
+		if(block.digest.isEmpty())
+		{
+			continue;
+		}
+		if(!file.seek(qint64(i) * BLOCK_SIZE))
+		{
+			return false;
+		}
+		unchanged = (file.read(block.sample.size()) == block.sample);
+	}
+
+	return true;
+}
+
+bool DigestThread::isPatchedInHeaderOnly(const QString &fileName)
+{
+	const QString suffix = QFileInfo(fileName).suffix().toLower();
+	for(size_t i = 0; HEADER_PATCH_ONLY[i]; i++)
+	{
+		if(suffix.compare(QLatin1String(HEADER_PATCH_ONLY[i])) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "thread_abstract.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QByteArray>
+
+class QFile;
+
+class DigestThread : public AbstractThread
+{
+	Q_OBJECT
+
+public:
+	DigestThread(const QString &fileName);
+	~DigestThread(void);
+
+	void stop(void);
+	bool complete(volatile bool *abort);
+	bool writeManifest(const QString &outputFile) const;
+	const QByteArray &getDigest(void) const { return m_digest; }
+
+protected:
+	static const int BLOCK_SIZE = 8388608;
+	static const int SAMPLE_SIZE = 4096;
+	static const unsigned long POLL_INTERVAL = 1000;
+
+	typedef struct
+	{
+		QByteArray digest;
+		QByteArray sample;
+	}
+	block_t;
+
+	const QString m_fileName;
+	volatile bool m_stopFlag;
+	QMutex m_mutex;
+	QWaitCondition m_stopped;
+
+	QList<block_t> m_blocks;
+	QByteArray m_digest;
+	qint64 m_fileSize;
+
+	//Entry point
+	virtual void run(void);
+
+	//Thread main
+	virtual int threadMain(void);
+
+	//Hashing
+	bool hashBlocks(QFile &file, const qint64 &limit, volatile bool *abort);
+	bool hashBlock(QFile &file, const int &index, block_t &block);
+	bool checkSamples(QFile &file, volatile bool *abort, bool &unchanged);
+	static bool isPatchedInHeaderOnly(const QString &fileName);
+};
@@ -28,7 +28,15 @@
 #include "model_sysinfo.h"
 #include "model_clipInfo.h"
 #include "job_object.h"
+#include "job_spool.h"
 #include "mediainfo.h"
+#include "cache_stats.h"
+#include "job_render.h"
+#include "job_stage.h"
+#include "job_placement.h"
+#include "job_descriptor.h"
+#include "thread_digest.h"
+#include "thread_log.h"
 
 //Encoders
 #include "encoder_factory.h"
@@ -51,6 +59,32 @@
 #include <QTextCodec>
 #include <QLocale>
 #include <QCryptographicHash>
+#include <QPair>
+#include <QElapsedTimer>
+
+//Windows includes
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+/*
+ * Output staging
+ */
+static const qint64 STAGE_CHUNK_SIZE = Q_INT64_C(8388608);
+static const qint64 STAGE_MIN_RESERVE = Q_INT64_C(1073741824);
+
+//Commit the file's data to its volume; this works on any handle of the file
+static bool FLUSH_FILE(const QString &fileName)
+{
+	const HANDLE hFile = CreateFileW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(fileName).utf16()), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	const BOOL success = FlushFileBuffers(hFile);
+	CloseHandle(hFile);
+	return (success != FALSE);
+}
 
 /*
  * RAII execution state handler
@@ -84,12 +118,14 @@ private:
 	if(ABORT_FLAG) \
 	{ \
 		log("\nPROCESS ABORTED BY USER !!!"); \
+		logStatistics(); \
 		setStatus(JobStatus_Aborted); \
 		if(QFileInfo(m_outputFileName).exists() && (QFileInfo(m_outputFileName).size() == 0)) QFile::remove(m_outputFileName); \
 		return 0; \
 	} \
 	else if(!(OK_FLAG)) \
 	{ \
+		logStatistics(); \
 		setStatus(JobStatus_Failed); \
 		if(QFileInfo(m_outputFileName).exists() && (QFileInfo(m_outputFileName).size() == 0)) QFile::remove(m_outputFileName); \
 		return 0; \
@@ -113,18 +149,25 @@ while(0)
 // Constructor & Destructor
 ///////////////////////////////////////////////////////////////////////////////
 
-EncodeThread::EncodeThread(const QString &sourceFileName, const QString &outputFileName, const OptionsModel *options, const SysinfoModel *const sysinfo, const PreferencesModel *const preferences)
+EncodeThread::EncodeThread(const JobDescriptor &job, const SysinfoModel *const sysinfo, const PreferencesModel *const preferences)
 :
-	m_jobId(QUuid::createUuid()),
-	m_sourceFileName(sourceFileName),
-	m_outputFileName(outputFileName),
-	m_options(new OptionsModel(*options)),
+	m_jobId(job.getId()),
+	m_sourceFileName(job.sourceFileName()),
+	m_outputFileName(job.outputFileName()),
+	m_options(new OptionsModel(*job.options())),
 	m_sysinfo(sysinfo),
 	m_preferences(preferences),
 	m_jobObject(new JobObject),
+	m_interactive(job.isInteractive()),
+	m_renderSpool(job.getRenderSpool()),
+	m_inputStage(job.getInputStage()),
+	m_ioPriority(0),
+	m_ioBandwidthLimit(0),
+	m_spool(NULL),
 	m_semaphorePaused(0),
 	m_encoder(NULL),
-	m_pipedSource(NULL)
+	m_pipedSource(NULL),
+	m_digestThread(NULL)
 {
 	m_abort = false;
 	m_pause = false;
@@ -156,6 +199,18 @@ EncodeThread::EncodeThread(const QString &sourceFileName, const QString &outputF
 
 EncodeThread::~EncodeThread(void)
 {
+	if(!m_renderSpool.isNull())
+	{
+		m_renderSpool->cancel();
+	}
+
+	if(!m_inputStage.isNull())
+	{
+		m_inputStage->cancel();
+	}
+
+	stopDigestThread();
+
 	MUTILS_DELETE(m_encoder);
 	MUTILS_DELETE(m_jobObject);
 	MUTILS_DELETE(m_options);
@@ -171,6 +226,23 @@ void EncodeThread::run(void)
 	m_progress = 0;
 	m_status = JobStatus_Starting;
 
+	//Must be done before the spool is created, as it records the output file
+	placeOutput();
+
+	//Keep processes alive if the application terminates unexpectedly?
+	if(m_preferences->getKeepJobsAlive())
+	{
+		m_spool = new JobSpool(m_jobId);
+		if(m_spool->create(m_sourceFileName, m_outputFileName, m_options, m_pipedSource && (!m_renderSpool.isNull())))
+		{
+			m_jobObject->setKillOnClose(false);
+		}
+		else
+		{
+			MUTILS_DELETE(m_spool);
+		}
+	}
+
 	AbstractThread::run();
 
 	if (m_exception)
@@ -179,11 +251,41 @@ void EncodeThread::run(void)
 		setStatus(JobStatus_Failed);
 	}
 
+	QMutexLocker lock(&m_mutexJobObject);
 	if(m_jobObject)
 	{
 		m_jobObject->terminateJob(42);
 		MUTILS_DELETE(m_jobObject);
 	}
+
+	if(m_spool)
+	{
+		m_spool->remove();
+		MUTILS_DELETE(m_spool);
+	}
+
+	LogWriter::close(m_jobId);
+
+	if(!m_renderSpool.isNull())
+	{
+		m_renderSpool->cancel();
+		m_renderSpool.clear();
+	}
+
+	if(!m_inputStage.isNull())
+	{
+		m_inputStage->cancel();
+		m_inputStage.clear();
+	}
+
+	if(!m_scratchFile.isEmpty())
+	{
+		QFile::remove(m_scratchFile);
+		m_scratchFile.clear();
+	}
+
+	OutputPlacement::release(m_jobId);
+	stopDigestThread();
 }
 
 void EncodeThread::start(Priority priority)
@@ -197,6 +299,50 @@ void EncodeThread::start(Priority priority)
 	AbstractThread::start(priority);
 }
 
+void EncodeThread::pauseJob(void)
+{
+	//The worker thread suspends the job, but only once it is inside of an encoding pass
+	m_pause = true;
+}
+
+void EncodeThread::resumeJob(void)
+{
+	m_pause = false;
+	m_semaphorePaused.release();
+}
+
+void EncodeThread::abortJob(void)
+{
+	m_abort = true;
+	m_pause = false;
+	m_semaphorePaused.release();
+}
+
+void EncodeThread::setIoClass(const int &ioPriority, const unsigned int &ioBandwidthLimit)
+{
+	QMutexLocker lock(&m_mutexJobObject);
+	if(m_jobObject)
+	{
+		if(m_ioPriority != ioPriority)
+		{
+			m_jobObject->setIoPriority(m_ioPriority = ioPriority);
+		}
+		if(m_ioBandwidthLimit != ioBandwidthLimit)
+		{
+			m_jobObject->setIoRateLimit(m_ioBandwidthLimit = ioBandwidthLimit);
+		}
+	}
+}
+
+void EncodeThread::sampleResourceUsage(void)
+{
+	QMutexLocker lock(&m_mutexJobObject);
+	if(m_jobObject)
+	{
+		m_jobObject->sampleMemoryUsage(true);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Encode functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -252,6 +398,9 @@ int EncodeThread::threadMain(void)
 	//Is encoder version suppoprted?
 	CHECK_STATUS(m_abort, (ok = m_encoder->isVersionSupported(encoderRevision, encoderModified)));
 
+	//Are the custom parameters supported by the encoder?
+	m_encoder->checkCustomParams();
+
 	if(m_pipedSource)
 	{
 		log("\nDetect video source version:\n");
@@ -286,27 +435,131 @@ int EncodeThread::threadMain(void)
 		CHECK_STATUS(m_abort, ok);
 	}
 
+	//Now that the clip info is known, refine the space that is reserved on the output volume
+	OutputPlacement::updateEstimate(m_jobId, estimateOutputSize(clipInfo));
+
+	// -----------------------------------------------------------------------------------
+	// Input Staging
+	// -----------------------------------------------------------------------------------
+
+	//Read the input from the local copy, if available
+	if(!m_inputStage.isNull())
+	{
+		log(tr("\n--- STAGE INPUT ---\n"));
+		setDetails(tr("Waiting for the input file to be copied..."));
+		if(m_inputStage->waitForReady(&m_abort))
+		{
+			log(tr("Reading input from local copy: %1").arg(QDir::toNativeSeparators(m_inputStage->getStagedFile())));
+			m_encoder->setInputFile(m_inputStage->getStagedFile());
+		}
+		else
+		{
+			CHECK_STATUS(m_abort, true);
+			log(tr("Input staging has failed, reading input from original location."));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------
+	// Output Staging
+	// -----------------------------------------------------------------------------------
+
+	//Write the output to a local scratch file, if destination is on a network share
+	if(m_preferences->getStageOutput() && (!m_spool) && x264_is_remote_path(m_outputFileName))
+	{
+		log(tr("\n--- STAGE OUTPUT ---\n"));
+		if(createScratchFile(clipInfo))
+		{
+			log(tr("Writing output to local scratch file: %1").arg(QDir::toNativeSeparators(m_scratchFile)));
+			m_encoder->setOutputFile(m_scratchFile);
+		}
+		else
+		{
+			log(tr("Not enough free space in the temp folder, writing output to final destination."));
+		}
+	}
+
 	// -----------------------------------------------------------------------------------
 	// Encoding Passes
 	// -----------------------------------------------------------------------------------
 
-	//Run encoding passes
+	//Run encoding passes, the duration of the pass that writes the output is a sample for the output volume
+	QElapsedTimer outputTimer;
 	if(m_encoder->getEncoderInfo().rcModeToType(m_options->rcMode()) == AbstractEncoderInfo::RC_TYPE_MULTIPASS)
 	{
 		const QString passLogFile = getPasslogFile(m_outputFileName);
+		const QString statsKey = getStatsCacheKey(clipInfo);
 		
 		log(tr("\n--- ENCODING PASS #1 ---\n"));
-		ok = m_encoder->runEncodingPass(m_pipedSource, m_outputFileName, clipInfo, 1, passLogFile);
-		CHECK_STATUS(m_abort, ok);
+		if((!statsKey.isEmpty()) && StatsCache::restore(statsKey, passLogFile))
+		{
+			log(tr("Re-using cached first pass statistics, skipping pass #1."));
+		}
+		else
+		{
+			ok = m_encoder->runEncodingPass(m_pipedSource, m_outputFileName, clipInfo, 1, passLogFile, m_renderSpool.data());
+			CHECK_STATUS(m_abort, ok);
+			if(!statsKey.isEmpty())
+			{
+				StatsCache::store(statsKey, passLogFile);
+			}
+		}
 
 		log(tr("\n--- ENCODING PASS #2 ---\n"));
+		startDigestThread();
+		outputTimer.start();
 		ok = m_encoder->runEncodingPass(m_pipedSource, m_outputFileName, clipInfo, 2, passLogFile);
 		CHECK_STATUS(m_abort, ok);
 	}
 	else
 	{
 		log(tr("\n--- ENCODING VIDEO ---\n"));
-		ok = m_encoder->runEncodingPass(m_pipedSource, m_outputFileName, clipInfo);
+		startDigestThread();
+		outputTimer.start();
+		ok = m_encoder->runEncodingPass(m_pipedSource, m_outputFileName, clipInfo, 0, QString(), m_renderSpool.data());
+		CHECK_STATUS(m_abort, ok);
+	}
+
+	sampleOutputThroughput(outputTimer.elapsed());
+
+	// -----------------------------------------------------------------------------------
+	// Output Checksum
+	// -----------------------------------------------------------------------------------
+
+	//The encoder has closed the file now, only the header and the tail are hashed again, unless the data was moved
+	if(m_digestThread)
+	{
+		log(tr("\n--- CHECKSUM ---\n"));
+		setDetails(tr("Computing checksum of output file, please wait..."));
+		m_digestThread->stop();
+		m_digestThread->wait();
+		if(m_digestThread->complete(&m_abort))
+		{
+			log(tr("BLAKE2 digest: %1").arg(QString::fromLatin1(m_digestThread->getDigest())));
+		}
+		else
+		{
+			CHECK_STATUS(m_abort, true);
+			log(tr("Failed to compute the checksum of the output file!"));
+			stopDigestThread();
+		}
+	}
+
+	// -----------------------------------------------------------------------------------
+	// Copy Output
+	// -----------------------------------------------------------------------------------
+
+	//Move the output to its final destination, the next job can start in the meantime
+	if(!m_scratchFile.isEmpty())
+	{
+		log(tr("\n--- COPY OUTPUT ---\n"));
+		setStatus(JobStatus_Finalizing);
+		setDetails(tr("Copying output file to destination, please wait..."));
+		ok = copyScratchFile();
+		if(!ok)
+		{
+			log(tr("The encoded file has been kept at: %1").arg(QDir::toNativeSeparators(m_scratchFile)));
+			m_scratchFile.clear();
+		}
 		CHECK_STATUS(m_abort, ok);
 	}
 
@@ -314,10 +567,27 @@ int EncodeThread::threadMain(void)
 	// Encoding complete
 	// -----------------------------------------------------------------------------------
 
+	if(m_digestThread)
+	{
+		const QString manifestFile = QString("%1.manifest").arg(m_outputFileName);
+		if(m_digestThread->writeManifest(m_outputFileName))
+		{
+			log(tr("\nChecksum manifest saved to: %1").arg(QDir::toNativeSeparators(manifestFile)));
+		}
+		else
+		{
+			log(tr("\nFailed to save checksum manifest: %1").arg(QDir::toNativeSeparators(manifestFile)));
+		}
+		stopDigestThread();
+	}
+
 	log(tr("\n--- COMPLETED ---\n"));
 
+	OutputPlacement::release(m_jobId);
+
 	int timePassed = startTime.secsTo(QDateTime::currentDateTime());
 	log(tr("Job finished at %1, %2. Process took %3 minutes, %4 seconds.").arg(QDate::currentDate().toString(Qt::ISODate), QTime::currentTime().toString(Qt::ISODate), QString::number(timePassed / 60), QString::number(timePassed % 60)));
+	logStatistics();
 	setStatus(JobStatus_Completed);
 
 	return 1; /*completed*/
@@ -329,7 +599,9 @@ int EncodeThread::threadMain(void)
 
 void EncodeThread::log(const QString &text)
 {
-	emit messageLogged(m_jobId, QDateTime::currentMSecsSinceEpoch(), text);
+	const qint64 timeStamp = QDateTime::currentMSecsSinceEpoch();
+	const qint64 sequence = LogWriter::append(m_jobId, timeStamp, text);
+	emit messageLogged(m_jobId, sequence, timeStamp, text);
 }
 
 void EncodeThread::setStatus(const JobStatus &newStatus)
@@ -348,6 +620,11 @@ void EncodeThread::setStatus(const JobStatus &newStatus)
 		{
 			setDetails("The job was aborted by the user!");
 		}
+		if(m_spool && ((newStatus == JobStatus_Running) || (newStatus == JobStatus_Running_Pass1) || (newStatus == JobStatus_Running_Pass2)))
+		{
+			const int pass = (newStatus == JobStatus_Running_Pass1) ? 1 : ((newStatus == JobStatus_Running_Pass2) ? 2 : 0);
+			m_spool->updateProcess(m_jobObject->getLastProcessId(), pass); /*encoder is always started last*/
+		}
 		m_status = newStatus;
 		emit statusChanged(m_jobId, newStatus);
 	}
@@ -371,6 +648,21 @@ void EncodeThread::setDetails(const QString &text)
 	}
 }
 
+void EncodeThread::logStatistics(void)
+{
+	JobStatistics stats;
+	if(m_jobObject && m_jobObject->queryStatistics(stats))
+	{
+		log(tr("\n--- RESOURCE USAGE ---\n"));
+		log(tr("CPU Time  : %1 (User), %2 (Kernel)").arg(timeToString(stats.userTime), timeToString(stats.kernelTime)));
+		log(tr("Memory    : %1 (Peak Resident), %2 (Peak Committed)").arg(AbstractEncoder::sizeToString(stats.peakWorkingSet), AbstractEncoder::sizeToString(stats.peakCommitted)));
+		log(tr("I/O Read  : %1 (%2 operations)").arg(AbstractEncoder::sizeToString(stats.readBytes), QString::number(stats.readOperations)));
+		log(tr("I/O Write : %1 (%2 operations)").arg(AbstractEncoder::sizeToString(stats.writeBytes), QString::number(stats.writeOperations)));
+		log(tr("Processes : %1").arg(QString::number(stats.processCount)));
+		emit statisticsChanged(m_jobId, stats);
+	}
+}
+
 QString EncodeThread::getPasslogFile(const QString &outputFile)
 {
 	QFileInfo info(outputFile);
@@ -384,3 +676,253 @@ QString EncodeThread::getPasslogFile(const QString &outputFile)
 
 	return passLogFile;
 }
+
+QString EncodeThread::getStatsCacheKey(const ClipInfo &clipInfo)
+{
+	//Avisynth/VapourSynth scripts may load any number of other files (and plug-ins), which the key can not cover
+	if(m_pipedSource)
+	{
+		return QString();
+	}
+
+	const QString encoderBinary = m_encoder->getEncoderInfo().getBinaryPath(m_sysinfo, m_options->encArch(), m_options->encVariant());
+	const QPair<quint32, quint32> frameSize = clipInfo.getFrameSize(), frameRate = clipInfo.getFrameRate();
+
+	//The target bitrate is NOT included, so different bitrates can share the first pass
+	QStringList params;
+	params << QString::number(x264_version_build());
+	params << QString::number(m_options->encType()) << QString::number(m_options->encArch()) << QString::number(m_options->encVariant());
+	params << QString::number(m_options->rcMode());
+	params << m_options->preset() << m_options->tune() << m_options->profile();
+	params << m_options->customEncParams() << m_options->customAvs2YUV();
+	params << QString::number(clipInfo.getFrameCount());
+	params << QString("%1x%2").arg(QString::number(frameSize.first), QString::number(frameSize.second));
+	params << QString("%1/%2").arg(QString::number(frameRate.first), QString::number(frameRate.second));
+
+	return StatsCache::makeKey(QStringList() << m_sourceFileName << encoderBinary, params);
+}
+
+/*
+ * Picks a volume for the output, if the destination is a pool. This can take a while, because it may need to probe
+ * the volumes first, which is why it is done here and not when the job is started by the job list
+ */
+void EncodeThread::placeOutput(void)
+{
+	//Piped sources pass no estimate and get a default reservation, it is refined once the clip info is known
+	const QString placedFile = OutputPlacement::place(m_jobId, m_outputFileName, estimateOutputSize(ClipInfo()));
+	if(!placedFile.isEmpty())
+	{
+		m_outputFileName = placedFile;
+		m_encoder->setOutputFile(placedFile);
+		emit outputPlaced(m_jobId, placedFile);
+	}
+}
+
+/*
+ * The output is committed to the volume first, so the whole pass (including the flush) is a lower bound of the time
+ * that the volume needed for writing it. Has no effect when the output was written to a scratch file or not placed.
+ */
+void EncodeThread::sampleOutputThroughput(const qint64 &duration)
+{
+	if(m_scratchFile.isEmpty())
+	{
+		QElapsedTimer timer;
+		timer.start();
+		if(FLUSH_FILE(m_outputFileName))
+		{
+			OutputPlacement::addOutputSample(m_jobId, QFileInfo(m_outputFileName).size(), duration + timer.elapsed());
+		}
+	}
+}
+
+qint64 EncodeThread::estimateOutputSize(const ClipInfo &clipInfo) const
+{
+	const AbstractEncoderInfo::RCType rcType = m_encoder->getEncoderInfo().rcModeToType(m_options->rcMode());
+	const QPair<quint32, quint32> frameRate = clipInfo.getFrameRate();
+
+	//Bitrate modes can be estimated from the duration, otherwise assume the output is not larger than the source
+	if((rcType != AbstractEncoderInfo::RC_TYPE_QUANTIZER) && (clipInfo.getFrameCount() > 0) && (frameRate.first > 0) && (frameRate.second > 0))
+	{
+		return (qint64(m_options->bitrate()) * Q_INT64_C(125) * qint64(clipInfo.getFrameCount()) * qint64(frameRate.second)) / qint64(frameRate.first);
+	}
+	if(!m_pipedSource)
+	{
+		return QFileInfo(m_sourceFileName).size();
+	}
+
+	return 0;
+}
+
+bool EncodeThread::createScratchFile(const ClipInfo &clipInfo)
+{
+	const qint64 estimate = estimateOutputSize(clipInfo);
+	log(tr("Estimated output size: %1").arg(estimate > 0 ? AbstractEncoder::sizeToString(estimate) : tr("Unknown")));
+
+	//The encoder (re)creates the output file, so we can only make sure that the space is available up front
+	quint64 freeSpace = 0;
+	if(!MUtils::OS::free_diskspace(QDir::tempPath(), freeSpace))
+	{
+		return false;
+	}
+	if(qint64(freeSpace) < (estimate + (estimate / 8) + STAGE_MIN_RESERVE))
+	{
+		return false;
+	}
+
+	//Keep the suffix, because the encoder selects the container format from it
+	m_scratchFile = QString("%1/~%2.%3").arg(QDir::tempPath(), m_jobId.toString().mid(1, 36), QFileInfo(m_outputFileName).suffix());
+	return true;
+}
+
+bool EncodeThread::copyScratchFile(void)
+{
+	QFile source(m_scratchFile);
+	if(!source.open(QIODevice::ReadOnly))
+	{
+		log(tr("Failed to open the scratch file for reading!"));
+		return false;
+	}
+
+	//Copy to a temporary file next to the destination first, so an incomplete file never shows up
+	const QFileInfo outputInfo(m_outputFileName);
+	const QString tempFile = QString("%1/~%2.tmp").arg(outputInfo.absolutePath(), m_jobId.toString().mid(1, 36));
+	QFile target(tempFile);
+	if(!target.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		log(tr("Failed to open the destination file for writing!"));
+		return false;
+	}
+
+	const qint64 totalSize = source.size();
+	QCryptographicHash sourceHash(QCryptographicHash::Sha1);
+	qint64 copied = 0, writeTime = 0;
+	bool success = target.resize(totalSize) && target.seek(0);
+	QElapsedTimer timer;
+
+	//Copy with large sequential writes
+	while(success && (copied < totalSize))
+	{
+		if(m_abort)
+		{
+			success = false;
+			break;
+		}
+		const QByteArray buffer = source.read(STAGE_CHUNK_SIZE);
+		timer.start();
+		const bool written = (!buffer.isEmpty()) && (target.write(buffer) == buffer.size());
+		writeTime += timer.elapsed();
+		if(!written)
+		{
+			log(tr("Failed to copy the output file: %1").arg(target.errorString()));
+			success = false;
+			break;
+		}
+		sourceHash.addData(buffer);
+		copied += buffer.size();
+		setProgress(static_cast<unsigned int>((copied * Q_INT64_C(50)) / qMax(totalSize, Q_INT64_C(1))));
+	}
+
+	timer.start();
+	success = target.flush() && success;
+	target.close();
+	source.close();
+
+	//Make sure the data has actually been committed to the destination, not just to the cache
+	success = success && FLUSH_FILE(tempFile);
+	writeTime += timer.elapsed();
+
+	//Only the time spent writing tells how fast the output volume is
+	if(success)
+	{
+		OutputPlacement::addWriteSample(m_jobId, totalSize, writeTime);
+	}
+
+	//Read back the copy and verify that it is identical
+	if(success)
+	{
+		success = verifyCopiedFile(tempFile, totalSize, sourceHash.result());
+		if((!success) && (!m_abort))
+		{
+			log(tr("Verification of the copied output file has failed!"));
+		}
+	}
+
+	if(success && x264_replace_file(tempFile, m_outputFileName))
+	{
+		log(tr("Output file has been copied and verified (%1).").arg(AbstractEncoder::sizeToString(totalSize)));
+		QFile::remove(m_scratchFile);
+		m_scratchFile.clear();
+		return true;
+	}
+
+	QFile::remove(tempFile);
+	return false;
+}
+
+/*
+ * Reads the file with FILE_FLAG_NO_BUFFERING, so the data comes from the destination volume rather than from the cache
+ */
+bool EncodeThread::verifyCopiedFile(const QString &fileName, const qint64 &totalSize, const QByteArray &expectedHash)
+{
+	const HANDLE hFile = CreateFileW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(fileName).utf16()), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+	{
+		log(tr("Failed to open the copied output file for verification!"));
+		return false;
+	}
+
+	//Unbuffered reads require a sector-aligned buffer, which VirtualAlloc() guarantees
+	char *const buffer = static_cast<char*>(VirtualAlloc(NULL, static_cast<SIZE_T>(STAGE_CHUNK_SIZE), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+	if(!buffer)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	QCryptographicHash targetHash(QCryptographicHash::Sha1);
+	qint64 verified = 0;
+	while((verified < totalSize) && (!m_abort))
+	{
+		DWORD bytesRead = 0;
+		if((!ReadFile(hFile, buffer, static_cast<DWORD>(STAGE_CHUNK_SIZE), &bytesRead, NULL)) || (bytesRead < 1))
+		{
+			break;
+		}
+		targetHash.addData(buffer, static_cast<int>(bytesRead));
+		verified += bytesRead;
+		setProgress(static_cast<unsigned int>(50 + ((verified * Q_INT64_C(50)) / qMax(totalSize, Q_INT64_C(1)))));
+	}
+
+	VirtualFree(buffer, 0, MEM_RELEASE);
+	CloseHandle(hFile);
+	return (verified == totalSize) && (targetHash.result() == expectedHash);
+}
+
+void EncodeThread::startDigestThread(void)
+{
+	if(m_preferences->getSaveChecksums() && (!m_digestThread))
+	{
+		m_digestThread = new DigestThread(m_scratchFile.isEmpty() ? m_outputFileName : m_scratchFile);
+		m_digestThread->start(QThread::LowestPriority);
+	}
+}
+
+void EncodeThread::stopDigestThread(void)
+{
+	if(m_digestThread)
+	{
+		m_digestThread->stop();
+		if(!m_digestThread->wait(5000))
+		{
+			m_digestThread->terminate();
+			m_digestThread->wait();
+		}
+		MUTILS_DELETE(m_digestThread);
+	}
+}
+
+QString EncodeThread::timeToString(const quint64 &msec)
+{
+	const quint64 seconds = msec / 1000ULL;
+	return QString().sprintf("%u:%02u:%02u.%03u", static_cast<unsigned int>(seconds / 3600ULL), static_cast<unsigned int>((seconds / 60ULL) % 60ULL), static_cast<unsigned int>(seconds % 60ULL), static_cast<unsigned int>(msec % 1000ULL));
+}
@@ -29,21 +29,28 @@
 #include <QMutex>
 #include <QStringList>
 #include <QSemaphore>
+#include <QSharedPointer>
 
 class SysinfoModel;
 class PreferencesModel;
 class OptionsModel;
 class QProcess;
 class JobObject;
+class JobSpool;
 class AbstractEncoder;
 class AbstractSource;
+class ClipInfo;
+class RenderSpool;
+class InputStage;
+class DigestThread;
+class JobDescriptor;
 
 class EncodeThread : public AbstractThread
 {
 	Q_OBJECT
 
 public:
-	EncodeThread(const QString &sourceFileName, const QString &outputFileName, const OptionsModel *options, const SysinfoModel *const sysinfo, const PreferencesModel *const m_preferences);
+	EncodeThread(const JobDescriptor &job, const SysinfoModel *const sysinfo, const PreferencesModel *const m_preferences);
 	~EncodeThread(void);
 
 	QUuid getId(void) { return this->m_jobId; };
@@ -51,23 +58,14 @@ public:
 	const QString &outputFileName(void) const { return this->m_outputFileName; }
 	const OptionsModel *options(void)   const { return m_options; }
 	
-	void pauseJob(void)
-	{
-		m_pause = true;
-	}
-
-	void resumeJob(void)
-	{
-		m_pause = false;
-		m_semaphorePaused.release();
-	}
-
-	void abortJob(void)
-	{
-		m_abort = true;
-		m_pause = false;
-		m_semaphorePaused.release();
-	}
+	void pauseJob(void);
+	void resumeJob(void);
+	void abortJob(void);
+
+	bool isInteractive(void) const { return m_interactive; }
+	void setInteractive(const bool &interactive) { m_interactive = interactive; }
+	void setIoClass(const int &ioPriority, const unsigned int &ioBandwidthLimit);
+	void sampleResourceUsage(void);
 
 protected:
 	//Globals
@@ -78,17 +76,36 @@ protected:
 	const QUuid m_jobId;
 	const OptionsModel *m_options;
 	const QString m_sourceFileName;
-	const QString m_outputFileName;
+	QString m_outputFileName;
 
 	//Flags
 	volatile bool m_abort;
 	volatile bool m_pause;
+	bool m_interactive;
 	
 	//Synchronization
 	QSemaphore m_semaphorePaused;
 
 	//Job Object
 	JobObject *m_jobObject;
+	QMutex m_mutexJobObject;
+	int m_ioPriority;
+	unsigned int m_ioBandwidthLimit;
+
+	//Spool for crash recovery
+	JobSpool *m_spool;
+
+	//Spool for render-ahead
+	QSharedPointer<RenderSpool> m_renderSpool;
+
+	//Local copy of the input file
+	QSharedPointer<InputStage> m_inputStage;
+
+	//Local scratch file for the output
+	QString m_scratchFile;
+
+	//Checksum of the output
+	DigestThread *m_digestThread;
 
 	//Internal status values
 	JobStatus m_status;
@@ -107,12 +124,35 @@ protected:
 
 	//Static functions
 	static QString getPasslogFile(const QString &outputFile);
+	static QString timeToString(const quint64 &msec);
+
+	//Resource usage
+	void logStatistics(void);
+
+	//Pass-1 statistics
+	QString getStatsCacheKey(const ClipInfo &clipInfo);
+
+	//Output placement
+	void placeOutput(void);
+	void sampleOutputThroughput(const qint64 &duration);
+
+	//Output staging
+	bool createScratchFile(const ClipInfo &clipInfo);
+	bool copyScratchFile(void);
+	bool verifyCopiedFile(const QString &fileName, const qint64 &totalSize, const QByteArray &expectedHash);
+	qint64 estimateOutputSize(const ClipInfo &clipInfo) const;
+
+	//Output checksum
+	void startDigestThread(void);
+	void stopDigestThread(void);
 
 signals:
 	void statusChanged(const QUuid &jobId, const JobStatus &newStatus);
 	void progressChanged(const QUuid &jobId, const unsigned int &newProgress);
-	void messageLogged(const QUuid &jobId, qint64, const QString &text);
+	void messageLogged(const QUuid &jobId, qint64, qint64, const QString &text);
 	void detailsChanged(const QUuid &jobId, const QString &details);
+	void statisticsChanged(const QUuid &jobId, const JobStatistics &statistics);
+	void outputPlaced(const QUuid &jobId, const QString &outputFile);
 
 private slots:
 	void log(const QString &text);
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_index.h"
+
+//Internal
+#include "global.h"
+#include "cache_index.h"
+#include "tool_abstract.h"
+#include "job_object.h"
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/OSSupport.h>
+
+//Qt
+#include <QProcess>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+//Background indexing always runs with the lowest priority
+static const int INDEX_PRIORITY = -2;
+
+////////////////////////////////////////////////////////////
+// Constructor & Destructor
+////////////////////////////////////////////////////////////
+
+IndexThread::IndexThread(void)
+{
+	m_stopFlag = false;
+}
+
+IndexThread::~IndexThread(void)
+{
+}
+
+////////////////////////////////////////////////////////////
+// Public Methods
+////////////////////////////////////////////////////////////
+
+void IndexThread::enqueue(const QString &program, const QStringList &args, const QString &indexFile)
+{
+	QMutexLocker lock(&m_mutex);
+
+	for(QQueue<task_t>::ConstIterator iter = m_tasks.constBegin(); iter != m_tasks.constEnd(); iter++)
+	{
+		if(iter->indexFile.compare(indexFile, Qt::CaseInsensitive) == 0)
+		{
+			return; /*already pending*/
+		}
+	}
+
+	task_t task;
+	task.program = program;
+	task.args = args;
+	task.indexFile = indexFile;
+
+	m_tasks.enqueue(task);
+	m_pending.wakeAll();
+}
+
+void IndexThread::stop(void)
+{
+	QMutexLocker lock(&m_mutex);
+	m_stopFlag = true;
+	m_tasks.clear();
+	m_pending.wakeAll();
+}
+
+////////////////////////////////////////////////////////////
+// Thread Main
+////////////////////////////////////////////////////////////
+
+void IndexThread::run(void)
+{
+	setTerminationEnabled(true);
+	AbstractThread::run();
+}
+
+int IndexThread::threadMain(void)
+{
+	IndexCache::removeStaleTempFiles();
+
+	forever
+	{
+		task_t task;
+		{
+			QMutexLocker lock(&m_mutex);
+			while(m_tasks.isEmpty() && (!m_stopFlag))
+			{
+				m_pending.wait(&m_mutex);
+			}
+			if(m_stopFlag)
+			{
+				break;
+			}
+			task = m_tasks.dequeue();
+		}
+		if((!runTask(task)) && (!m_stopFlag))
+		{
+			qWarning("Background indexing has failed: %s", task.indexFile.toUtf8().constData());
+		}
+	}
+
+	return 1;
+}
+
+////////////////////////////////////////////////////////////
+// Indexing
+////////////////////////////////////////////////////////////
+
+bool IndexThread::runTask(const task_t &task)
+{
+	if(QFileInfo(task.indexFile).exists())
+	{
+		IndexCache::touch(task.indexFile);
+		return true; /*already indexed*/
+	}
+
+	if(!IndexCache::tryLock(task.indexFile))
+	{
+		return true; /*job is running already*/
+	}
+
+	const QString tempFile = IndexCache::getTempFile(task.indexFile);
+	QFile::remove(tempFile);
+
+	//The job object makes sure the indexer does not survive the application
+	JobObject jobObject;
+
+	QProcess process;
+	MUtils::init_process(process, QDir::tempPath(), true);
+
+	bool success = false;
+	if(AbstractTool::launchProcess(process, task.program, task.args, &jobObject))
+	{
+		MUtils::OS::change_process_priority(&process, INDEX_PRIORITY);
+		while(process.state() != QProcess::NotRunning)
+		{
+			if(m_stopFlag)
+			{
+				process.kill();
+				process.waitForFinished(-1);
+				break;
+			}
+			process.waitForFinished(1000);
+			process.readAll(); /*discard output*/
+		}
+		success = (!m_stopFlag) && (process.exitStatus() == QProcess::NormalExit) && (process.exitCode() == EXIT_SUCCESS);
+	}
+
+	if(success && QFileInfo(tempFile).exists())
+	{
+		success = x264_replace_file(tempFile, task.indexFile);
+	}
+	else
+	{
+		success = false;
+	}
+
+	if(!success)
+	{
+		QFile::remove(tempFile);
+	}
+
+	IndexCache::unlock(task.indexFile);
+	if(success)
+	{
+		IndexCache::touch(task.indexFile);
+	}
+
+	return success;
+}
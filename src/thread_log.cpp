@@ -0,0 +1,364 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_log.h"
+
+//Internal
+#include "global.h"
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QStringList>
+
+//CRT
+#include <io.h>
+
+//Windows includes
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+//Pending lines are written at least this often, the files are synced to disk less frequently
+static const unsigned long WRITE_INTERVAL = 250;
+static const qint64 SYNC_INTERVAL = 5000;
+
+//Logs of jobs that are gone, e.g. after a crash, are kept for some time
+static const int MAX_AGE_DAYS = 7;
+
+QMutex         LogWriter::s_mutex;
+QWaitCondition LogWriter::s_pending;
+QWaitCondition LogWriter::s_idle;
+LogWriter     *LogWriter::s_instance = NULL;
+bool           LogWriter::s_shutdown = false;
+qint64         LogWriter::s_sequence = 0;
+
+////////////////////////////////////////////////////////////
+// Constructor & Destructor
+////////////////////////////////////////////////////////////
+
+LogWriter::LogWriter(void)
+:
+	m_busy(false)
+{
+	m_stopFlag = false;
+}
+
+LogWriter::~LogWriter(void)
+{
+	for(QHash<QUuid, QFile*>::Iterator iter = m_files.begin(); iter != m_files.end(); iter++)
+	{
+		MUTILS_DELETE(iter.value());
+	}
+}
+
+////////////////////////////////////////////////////////////
+// Public Methods
+////////////////////////////////////////////////////////////
+
+/*
+ * Returns the sequence number of the message, which is also stored in the log file
+ */
+qint64 LogWriter::append(const QUuid &jobId, const qint64 &timeStamp, const QString &text)
+{
+	task_t task;
+	task.type = TASK_APPEND;
+	task.jobId = jobId;
+	task.timeStamp = timeStamp;
+	task.text = text;
+	return enqueue(task);
+}
+
+void LogWriter::close(const QUuid &jobId)
+{
+	task_t task;
+	task.type = TASK_CLOSE;
+	task.jobId = jobId;
+	task.timeStamp = 0;
+	enqueue(task);
+}
+
+void LogWriter::remove(const QUuid &jobId)
+{
+	task_t task;
+	task.type = TASK_REMOVE;
+	task.jobId = jobId;
+	task.timeStamp = 0;
+	enqueue(task);
+}
+
+void LogWriter::sync(void)
+{
+	QMutexLocker lock(&s_mutex);
+	while(s_instance && (s_instance->m_busy || (!s_instance->m_tasks.isEmpty())) && s_instance->isRunning())
+	{
+		s_pending.wakeAll();
+		s_idle.wait(&s_mutex, WRITE_INTERVAL);
+	}
+}
+
+void LogWriter::shutdown(void)
+{
+	QMutexLocker lock(&s_mutex);
+	LogWriter *const instance = s_instance;
+	s_instance = NULL;
+	s_shutdown = true;
+	if(!instance)
+	{
+		return;
+	}
+
+	instance->m_stopFlag = true;
+	s_pending.wakeAll();
+	lock.unlock();
+
+	if(!instance->wait(5000))
+	{
+		instance->terminate();
+		instance->wait();
+	}
+	delete instance;
+}
+
+QString LogWriter::getLogFile(const QUuid &jobId)
+{
+	return QString("%1/%2.log").arg(getLogDir(), jobId.toString().mid(1, 36));
+}
+
+QList<LogWriter::LogEntry> LogWriter::load(const QUuid &jobId)
+{
+	QList<LogEntry> entries;
+
+	QFile logFile(getLogFile(jobId));
+	if(logFile.open(QIODevice::ReadOnly))
+	{
+		while(!logFile.atEnd())
+		{
+			const QString line = QString::fromUtf8(logFile.readLine()).remove(QChar('\n'));
+			const int separator1 = line.indexOf(QChar('\t'));
+			const int separator2 = (separator1 > 0) ? line.indexOf(QChar('\t'), separator1 + 1) : -1;
+			if(separator2 > separator1)
+			{
+				LogEntry entry;
+				entry.sequence = line.left(separator1).toLongLong();
+				entry.timeStamp = line.mid(separator1 + 1, separator2 - separator1 - 1).toLongLong();
+				entry.text = line.mid(separator2 + 1);
+				entries << entry;
+			}
+		}
+		logFile.close();
+	}
+
+	return entries;
+}
+
+////////////////////////////////////////////////////////////
+// Internal Methods
+////////////////////////////////////////////////////////////
+
+qint64 LogWriter::enqueue(task_t &task)
+{
+	QMutexLocker lock(&s_mutex);
+
+	//Sequence numbers must keep growing across sessions too, because the logs of recovered jobs are continued
+	if(s_sequence == 0)
+	{
+		s_sequence = QDateTime::currentMSecsSinceEpoch() * Q_INT64_C(1000);
+	}
+	task.sequence = ++s_sequence;
+
+	if(s_shutdown)
+	{
+		return task.sequence;
+	}
+
+	if(!s_instance)
+	{
+		purge();
+		s_instance = new LogWriter();
+		s_instance->start(QThread::LowPriority);
+	}
+
+	s_instance->m_tasks.enqueue(task);
+	return task.sequence;
+}
+
+QString LogWriter::getLogDir(void)
+{
+	return QString("%1/logs").arg(x264_data_path());
+}
+
+void LogWriter::purge(void)
+{
+	const QString logDir = getLogDir();
+	if(!QDir(logDir).exists())
+	{
+		QDir().mkpath(logDir);
+		return;
+	}
+
+	const QDateTime threshold = QDateTime::currentDateTime().addDays(-MAX_AGE_DAYS);
+	const QFileInfoList files = QDir(logDir).entryInfoList(QStringList() << "*.log", QDir::Files);
+	for(QFileInfoList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); iter++)
+	{
+		if(iter->lastModified() < threshold)
+		{
+			QFile::remove(iter->absoluteFilePath());
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////
+// Thread Main
+////////////////////////////////////////////////////////////
+
+void LogWriter::run(void)
+{
+	setTerminationEnabled(true);
+	AbstractThread::run();
+}
+
+int LogWriter::threadMain(void)
+{
+	QHash<QUuid, QFile*> pendingSync;
+	qint64 lastSync = QDateTime::currentMSecsSinceEpoch();
+
+	forever
+	{
+		QQueue<task_t> tasks;
+		{
+			QMutexLocker lock(&s_mutex);
+			m_busy = false;
+			s_idle.wakeAll();
+			if(m_tasks.isEmpty() && (!m_stopFlag))
+			{
+				s_pending.wait(&s_mutex, WRITE_INTERVAL);
+			}
+			tasks.swap(m_tasks);
+			m_busy = !tasks.isEmpty();
+		}
+
+		//Lines are collected and written in batches, the OS buffers are flushed periodically
+		process(tasks, pendingSync);
+
+		const qint64 now = QDateTime::currentMSecsSinceEpoch();
+		if(m_stopFlag || ((now - lastSync) >= SYNC_INTERVAL))
+		{
+			for(QHash<QUuid, QFile*>::ConstIterator iter = pendingSync.constBegin(); iter != pendingSync.constEnd(); iter++)
+			{
+				FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(iter.value()->handle())));
+			}
+			pendingSync.clear();
+			lastSync = now;
+		}
+
+		if(m_stopFlag)
+		{
+			QMutexLocker lock(&s_mutex);
+			if(m_tasks.isEmpty())
+			{
+				m_busy = false;
+				s_idle.wakeAll();
+				break;
+			}
+		}
+	}
+
+	return 1;
+}
+
+////////////////////////////////////////////////////////////
+// Writing
+////////////////////////////////////////////////////////////
+
+void LogWriter::process(const QQueue<task_t> &tasks, QHash<QUuid, QFile*> &pendingSync)
+{
+	QHash<QUuid, QFile*> touched;
+
+	for(QQueue<task_t>::ConstIterator iter = tasks.constBegin(); iter != tasks.constEnd(); iter++)
+	{
+		switch(iter->type)
+		{
+		case TASK_APPEND:
+			if(QFile *const file = getFile(iter->jobId))
+			{
+				const QString sequence = QString::number(iter->sequence), timeStamp = QString::number(iter->timeStamp);
+				const QStringList lines = iter->text.split("\n");
+				for(QStringList::ConstIterator line = lines.constBegin(); line != lines.constEnd(); line++)
+				{
+					file->write(QString("%1\t%2\t%3\n").arg(sequence, timeStamp, (*line)).toUtf8());
+				}
+				touched.insert(iter->jobId, file);
+				pendingSync.insert(iter->jobId, file);
+			}
+			break;
+		case TASK_CLOSE:
+		case TASK_REMOVE:
+			touched.remove(iter->jobId);
+			pendingSync.remove(iter->jobId);
+			if(QFile *file = m_files.take(iter->jobId))
+			{
+				if(iter->type == TASK_CLOSE)
+				{
+					file->flush();
+					FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(file->handle())));
+				}
+				file->close();
+				MUTILS_DELETE(file);
+			}
+			if(iter->type == TASK_REMOVE)
+			{
+				QFile::remove(getLogFile(iter->jobId));
+			}
+			break;
+		}
+	}
+
+	for(QHash<QUuid, QFile*>::ConstIterator iter = touched.constBegin(); iter != touched.constEnd(); iter++)
+	{
+		iter.value()->flush();
+	}
+}
+
+QFile *LogWriter::getFile(const QUuid &jobId)
+{
+	if(QFile *const file = m_files.value(jobId, NULL))
+	{
+		return file;
+	}
+
+	QFile *file = new QFile(getLogFile(jobId));
+	if(!file->open(QIODevice::WriteOnly | QIODevice::Append))
+	{
+		qWarning("Failed to open log file: %s", file->fileName().toUtf8().constData());
+		MUTILS_DELETE(file);
+		return NULL;
+	}
+
+	m_files.insert(jobId, file);
+	return file;
+}
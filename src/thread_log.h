@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "thread_abstract.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QHash>
+#include <QUuid>
+
+class QFile;
+
+class LogWriter : public AbstractThread
+{
+	Q_OBJECT
+
+public:
+	typedef struct
+	{
+		qint64 sequence;
+		qint64 timeStamp;
+		QString text;
+	}
+	LogEntry;
+
+	static qint64 append(const QUuid &jobId, const qint64 &timeStamp, const QString &text);
+	static void close(const QUuid &jobId);
+	static void remove(const QUuid &jobId);
+	static void sync(void);
+	static void shutdown(void);
+
+	static QString getLogFile(const QUuid &jobId);
+	static QList<LogEntry> load(const QUuid &jobId);
+
+protected:
+	typedef enum
+	{
+		TASK_APPEND = 0,
+		TASK_CLOSE  = 1,
+		TASK_REMOVE = 2
+	}
+	task_type_t;
+
+	typedef struct
+	{
+		task_type_t type;
+		QUuid jobId;
+		qint64 sequence;
+		qint64 timeStamp;
+		QString text;
+	}
+	task_t;
+
+	LogWriter(void);
+	~LogWriter(void);
+
+	static qint64 enqueue(task_t &task);
+	static QString getLogDir(void);
+	static void purge(void);
+
+	volatile bool m_stopFlag;
+	bool m_busy;
+	QQueue<task_t> m_tasks;
+	QHash<QUuid, QFile*> m_files;
+
+	//Entry point
+	virtual void run(void);
+
+	//Thread main
+	virtual int threadMain(void);
+
+	//Writing
+	void process(const QQueue<task_t> &tasks, QHash<QUuid, QFile*> &pendingSync);
+	QFile *getFile(const QUuid &jobId);
+
+	static QMutex s_mutex;
+	static QWaitCondition s_pending;
+	static QWaitCondition s_idle;
+	static LogWriter *s_instance;
+	static bool s_shutdown;
+	static qint64 s_sequence;
+};
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_render.h"
+
+//Internal
+#include "global.h"
+#include "job_render.h"
+#include "job_object.h"
+#include "tool_abstract.h"
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/OSSupport.h>
+
+//Qt
+#include <QProcess>
+#include <QDir>
+
+//CRT
+#include <stdlib.h>
+
+//Rendering ahead uses the lowest priority, until the job has started
+static const int IDLE_PRIORITY = -2;
+
+////////////////////////////////////////////////////////////
+// Constructor & Destructor
+////////////////////////////////////////////////////////////
+
+RenderThread::RenderThread(void)
+{
+	m_stopFlag = false;
+}
+
+RenderThread::~RenderThread(void)
+{
+}
+
+////////////////////////////////////////////////////////////
+// Public Methods
+////////////////////////////////////////////////////////////
+
+void RenderThread::enqueue(const QSharedPointer<RenderSpool> &spool)
+{
+	QMutexLocker lock(&m_mutex);
+	m_pending.append(spool);
+}
+
+void RenderThread::stop(void)
+{
+	m_stopFlag = true;
+}
+
+////////////////////////////////////////////////////////////
+// Thread Main
+////////////////////////////////////////////////////////////
+
+void RenderThread::run(void)
+{
+	setTerminationEnabled(true);
+	AbstractThread::run();
+}
+
+int RenderThread::threadMain(void)
+{
+	QList<task_t> tasks;
+
+	while(!m_stopFlag)
+	{
+		//Pick up new spools
+		{
+			QMutexLocker lock(&m_mutex);
+			while(!m_pending.isEmpty())
+			{
+				task_t task;
+				task.spool = m_pending.takeFirst();
+				task.process = NULL;
+				task.jobObject = NULL;
+				task.attached = false;
+				if(startTask(task))
+				{
+					tasks.append(task);
+				}
+			}
+		}
+
+		//Move data from the source processes into the spools
+		bool progress = false;
+		for(QList<task_t>::Iterator iter = tasks.begin(); iter != tasks.end();)
+		{
+			if(!updateTask(*iter, progress))
+			{
+				finishTask(*iter, false);
+				iter = tasks.erase(iter);
+				continue;
+			}
+			iter++;
+		}
+
+		if(!progress)
+		{
+			msleep(25);
+		}
+	}
+
+	while(!tasks.isEmpty())
+	{
+		task_t task = tasks.takeFirst();
+		finishTask(task, true);
+	}
+
+	return 1;
+}
+
+////////////////////////////////////////////////////////////
+// Rendering
+////////////////////////////////////////////////////////////
+
+bool RenderThread::startTask(task_t &task)
+{
+	if(task.spool->isCancelled() || (!task.spool->open()))
+	{
+		task.spool->finish(EXIT_FAILURE, QString());
+		return false;
+	}
+
+	task.process = new QProcess();
+	task.jobObject = new JobObject();
+	MUtils::init_process(*task.process, QDir::tempPath(), true, &task.spool->getExtraPaths(), &task.spool->getExtraEnv());
+	task.process->setProcessChannelMode(QProcess::SeparateChannels);
+	task.process->setReadChannel(QProcess::StandardOutput);
+
+	if(!AbstractTool::launchProcess(*task.process, task.spool->getProgram(), task.spool->getArgs(), task.jobObject))
+	{
+		qWarning("Failed to start the render-ahead process!");
+		finishTask(task, true);
+		return false;
+	}
+
+	MUtils::OS::change_process_priority(task.process, IDLE_PRIORITY);
+	return true;
+}
+
+bool RenderThread::updateTask(task_t &task, bool &progress)
+{
+	if(task.spool->isCancelled())
+	{
+		return false;
+	}
+
+	//Job has started, so the source should no longer be throttled
+	if((!task.attached) && task.spool->isAttached())
+	{
+		MUtils::OS::change_process_priority(task.process, task.spool->getPriority());
+		task.attached = true;
+	}
+
+	//Read no more than what fits into the spool, so the source gets blocked when the spool is full
+	const qint64 freeSpace = task.spool->getFreeSpace();
+	if(freeSpace > 0)
+	{
+		if((task.process->bytesAvailable() > 0) || task.process->waitForReadyRead(0))
+		{
+			const QByteArray data = task.process->read(qMin(freeSpace, qint64(CHUNK_SIZE)));
+			if(!data.isEmpty())
+			{
+				if(!task.spool->write(data))
+				{
+					qWarning("Failed to write to the render-ahead spool!");
+					return false;
+				}
+				progress = true;
+			}
+		}
+		else if(task.process->state() == QProcess::NotRunning)
+		{
+			return false; /*end of stream*/
+		}
+	}
+
+	return true;
+}
+
+void RenderThread::finishTask(task_t &task, const bool &abort)
+{
+	if(task.process)
+	{
+		if(abort || task.spool->isCancelled())
+		{
+			task.process->kill();
+		}
+		task.process->waitForFinished(-1);
+
+		const bool success = (!abort) && (task.process->exitStatus() == QProcess::NormalExit);
+		const QString messages = QString::fromUtf8(task.process->readAllStandardError());
+		task.spool->finish(success ? task.process->exitCode() : EXIT_FAILURE, messages);
+
+		task.process->close();
+		MUTILS_DELETE(task.process);
+	}
+
+	MUTILS_DELETE(task.jobObject);
+}
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "thread_abstract.h"
+
+#include <QMutex>
+#include <QList>
+#include <QSharedPointer>
+
+class RenderSpool;
+class JobObject;
+class QProcess;
+
+class RenderThread : public AbstractThread
+{
+	Q_OBJECT
+
+public:
+	RenderThread(void);
+	~RenderThread(void);
+
+	void enqueue(const QSharedPointer<RenderSpool> &spool);
+	void stop(void);
+
+protected:
+	typedef struct
+	{
+		QSharedPointer<RenderSpool> spool;
+		QProcess *process;
+		JobObject *jobObject;
+		bool attached;
+	}
+	task_t;
+
+	static const int CHUNK_SIZE = 4194304;
+
+	volatile bool m_stopFlag;
+	QMutex m_mutex;
+	QList<QSharedPointer<RenderSpool> > m_pending;
+
+	//Entry point
+	virtual void run(void);
+
+	//Thread main
+	virtual int threadMain(void);
+
+	//Rendering
+	static bool startTask(task_t &task);
+	static bool updateTask(task_t &task, bool &progress);
+	static void finishTask(task_t &task, const bool &abort);
+};
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "thread_stage.h"
+
+//Internal
+#include "global.h"
+#include "job_stage.h"
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QFile>
+#include <QFileInfo>
+
+////////////////////////////////////////////////////////////
+// Constructor & Destructor
+////////////////////////////////////////////////////////////
+
+StageThread::StageThread(void)
+{
+	m_stopFlag = false;
+}
+
+StageThread::~StageThread(void)
+{
+}
+
+////////////////////////////////////////////////////////////
+// Public Methods
+////////////////////////////////////////////////////////////
+
+void StageThread::enqueue(const QSharedPointer<InputStage> &stage)
+{
+	QMutexLocker lock(&m_mutex);
+	m_stages.enqueue(stage);
+	m_pending.wakeAll();
+}
+
+void StageThread::stop(void)
+{
+	QMutexLocker lock(&m_mutex);
+	m_stopFlag = true;
+	while(!m_stages.isEmpty())
+	{
+		m_stages.dequeue()->setState(InputStage::STAGE_FAILED);
+	}
+	m_pending.wakeAll();
+}
+
+////////////////////////////////////////////////////////////
+// Thread Main
+////////////////////////////////////////////////////////////
+
+void StageThread::run(void)
+{
+	setTerminationEnabled(true);
+	AbstractThread::run();
+}
+
+int StageThread::threadMain(void)
+{
+	forever
+	{
+		QSharedPointer<InputStage> stage;
+		{
+			QMutexLocker lock(&m_mutex);
+			while(m_stages.isEmpty() && (!m_stopFlag))
+			{
+				m_pending.wait(&m_mutex);
+			}
+			if(m_stopFlag)
+			{
+				break;
+			}
+			stage = m_stages.dequeue();
+		}
+
+		//Files are copied one at a time, so the share is read sequentially
+		if(stage->getState() == InputStage::STAGE_PENDING)
+		{
+			stage->setState(InputStage::STAGE_COPYING);
+			const bool success = copyFile(stage);
+			if(!success)
+			{
+				QFile::remove(stage->getStagedFile());
+			}
+			stage->setState(success ? InputStage::STAGE_READY : InputStage::STAGE_FAILED);
+		}
+	}
+
+	return 1;
+}
+
+////////////////////////////////////////////////////////////
+// Copying
+////////////////////////////////////////////////////////////
+
+bool StageThread::copyFile(const QSharedPointer<InputStage> &stage)
+{
+	QFile source(stage->getSourceFile()), target(stage->getStagedFile());
+
+	if(!source.open(QIODevice::ReadOnly))
+	{
+		qWarning("Failed to open source file for staging: %s", stage->getSourceFile().toUtf8().constData());
+		return false;
+	}
+	if(!target.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		qWarning("Failed to create staged file: %s", stage->getStagedFile().toUtf8().constData());
+		return false;
+	}
+
+	//Allocate the complete file up-front, so it will not be fragmented
+	if(!target.resize(source.size()))
+	{
+		qWarning("Not enough space for staged file: %s", stage->getStagedFile().toUtf8().constData());
+		return false;
+	}
+
+	qint64 totalBytes = 0;
+	while(!source.atEnd())
+	{
+		if(m_stopFlag || (stage->getState() == InputStage::STAGE_CANCELLED))
+		{
+			return false;
+		}
+		const QByteArray buffer = source.read(CHUNK_SIZE);
+		if(buffer.isEmpty() || (target.write(buffer) != buffer.size()))
+		{
+			qWarning("Failed to copy source file for staging: %s", stage->getSourceFile().toUtf8().constData());
+			return false;
+		}
+		totalBytes += buffer.size();
+	}
+
+	target.close();
+	return (totalBytes == stage->getSize()) && (QFileInfo(stage->getStagedFile()).size() == totalBytes);
+}
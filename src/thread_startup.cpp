@@ -21,6 +21,9 @@
 
 #include "thread_startup.h"
 
+//Internal
+#include "cache_file.h"
+
 //MUtils
 #include <MUtils/Global.h>
 
@@ -29,6 +32,9 @@
 #include <QElapsedTimer>
 #include <QProcess>
 
+//Cached probe results
+static FileCache g_probeCache("startup");
+
 //-------------------------------------
 // Constructor
 //-------------------------------------
@@ -123,3 +129,22 @@ QStringList StarupThread::runProcess(const QString &exePath, const QStringList &
 
 	return processOutput;
 }
+
+bool StarupThread::lookupProbe(const QStringList &files, QStringList &output)
+{
+	QVariant value;
+	if(g_probeCache.lookup(files, value))
+	{
+		output = value.toStringList();
+		return (!output.isEmpty());
+	}
+	return false;
+}
+
+void StarupThread::storeProbe(const QStringList &files, const QStringList &output, const QStringList &dependencies)
+{
+	if(!output.isEmpty())
+	{
+		g_probeCache.store(files, output, dependencies);
+	}
+}
@@ -39,4 +39,6 @@ protected slots:
 
 protected:
 	static QStringList runProcess(const QString &exePath, const QStringList &args, const QStringList *const extraPaths = NULL);
+	static bool lookupProbe(const QStringList &files, QStringList &output);
+	static void storeProbe(const QStringList &files, const QStringList &output, const QStringList &dependencies = QStringList());
 };
@@ -82,24 +82,12 @@ bool VapourSynthCheckThread::detect(SysinfoModel* sysinfo)
 	sysinfo->clearVPS32Path();
 	sysinfo->clearVPS64Path();
 
-	QEventLoop loop;
 	VapourSynthCheckThread thread;
 
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-
-	connect(&thread, SIGNAL(finished()), &loop, SLOT(quit()));
-	connect(&thread, SIGNAL(terminated()), &loop, SLOT(quit()));
-
 	thread.start();
-	QTimer::singleShot(30000, &loop, SLOT(quit()));
-
 	qDebug("VapourSynth thread has been created, please wait...");
-	loop.exec(QEventLoop::ExcludeUserInputEvents);
-	qDebug("VapourSynth thread finished.");
 
-	QApplication::restoreOverrideCursor();
-
-	if (!thread.wait(1000))
+	if (!thread.wait(30000))
 	{
 		qWarning("VapourSynth thread encountered timeout -> probably deadlock!");
 		thread.terminate();
@@ -265,7 +253,7 @@ int VapourSynthCheckThread::threadMain(void)
 			{
 				m_vpsExePath[i].reset(vpsExeFile);
 				m_vpsDllPath[i].reset(vpsDllFile);
-				if (checkVapourSynth(m_vpsExePath[i]->fileEngine()->fileName(QAbstractFileEngine::CanonicalName)))
+				if (checkVapourSynth(m_vpsExePath[i]->fileEngine()->fileName(QAbstractFileEngine::CanonicalName), m_vpsDllPath[i]->fileEngine()->fileName(QAbstractFileEngine::CanonicalName)))
 				{
 					qDebug("VapourSynth %u-Bit edition found!", VPS_BITNESS(i));
 					m_vpsPath[i] = m_vpsExePath[i]->fileEngine()->fileName(QAbstractFileEngine::CanonicalPathName);
@@ -341,10 +329,22 @@ bool VapourSynthCheckThread::isVapourSynthComplete(const QFileInfo& vpsDllInfo,
 	return complete;
 }
 
-bool VapourSynthCheckThread::checkVapourSynth(const QString &vspipePath)
+bool VapourSynthCheckThread::checkVapourSynth(const QString &vspipePath, const QString &vsscriptPath)
 {
+	//Re-use the previous result, if neither VSPIPE.EXE nor VSSCRIPT.DLL has changed
+	const QStringList probeFiles = QStringList() << vspipePath << vsscriptPath;
+	QStringList output;
+	const bool cached = lookupProbe(probeFiles, output);
+
 	//Try to run VSPIPE.EXE
-	const QStringList output = runProcess(vspipePath, QStringList() << "--version");
+	if(cached)
+	{
+		qDebug("Using cached VapourSynth check result.");
+	}
+	else
+	{
+		output = runProcess(vspipePath, QStringList() << "--version");
+	}
 
 	//Init regular expressions
 	QRegExp vpsLogo("VapourSynth\\s+Video\\s+Processing\\s+Library");
@@ -363,6 +363,10 @@ bool VapourSynthCheckThread::checkVapourSynth(const QString &vspipePath)
 	//Minimum required version found?
 	if(vapoursynthLogo)
 	{
+		if(!cached)
+		{
+			storeProbe(probeFiles, output);
+		}
 		qDebug("VapourSynth version was detected successfully.");
 		return true;
 	}
@@ -67,5 +67,5 @@ private:
 	//Internal functions
 	static VapourSynthFlags getVapourSynthType(const int scope);
 	static bool isVapourSynthComplete(const QFileInfo& vpsDllInfo, const QFileInfo& vpsExeInfo, QFile*& vpsExeFile, QFile*& vpsDllFile);
-	static bool checkVapourSynth(const QString &vspipePath);
+	static bool checkVapourSynth(const QString &vspipePath, const QString &vsscriptPath);
 };
@@ -27,6 +27,7 @@
 #include "model_preferences.h"
 #include "model_sysinfo.h"
 #include "job_object.h"
+#include "cache_version.h"
 
 //MUtils
 #include <MUtils/OSSupport.h>
@@ -86,6 +87,15 @@ unsigned int AbstractTool::checkVersion(bool &modified)
 		return makeRevision(0xFFF0, 0xFFF0);
 	}
 
+	//Try to re-use a previous result, as long as the binaries are unchanged
+	const QStringList versionFiles = QStringList() << getBinaryPath() << getVersionDependencies();
+	unsigned int cachedRevision = UINT_MAX;
+	if(VersionCache::lookup(versionFiles, cachedRevision, modified))
+	{
+		log(tr("Using cached version info for \"%1\".").arg(QDir::toNativeSeparators(getBinaryPath())));
+		return cachedRevision;
+	}
+
 	QProcess process;
 	QList<QRegExp*> patterns;
 	QStringList cmdLine;
@@ -161,7 +171,9 @@ unsigned int AbstractTool::checkVersion(bool &modified)
 		return UINT_MAX;
 	}
 	
-	return makeRevision(coreVers, revision);
+	const unsigned int result = makeRevision(coreVers, revision);
+	VersionCache::store(versionFiles, result, modified);
+	return result;
 }
 
 bool AbstractTool::checkVersion_succeeded(const int &exitCode)
@@ -175,7 +187,6 @@ bool AbstractTool::checkVersion_succeeded(const int &exitCode)
 
 bool AbstractTool::startProcess(QProcess &process, const QString &program, const QStringList &args, bool mergeChannels, const QStringList *const extraPaths, const QHash<QString, QString> *const extraEnv)
 {
-	QMutexLocker lock(&s_mutexStartProcess);
 	log(commandline2string(program, args) + "\n");
 
 	MUtils::init_process(process, QDir::tempPath(), true, extraPaths, extraEnv);
@@ -185,13 +196,9 @@ bool AbstractTool::startProcess(QProcess &process, const QString &program, const
 		process.setReadChannel(QProcess::StandardError);
 	}
 
-	process.start(program, args);
-	
-	if(process.waitForStarted())
+	if(launchProcess(process, program, args, m_jobObject))
 	{
-		m_jobObject->addProcessToJob(&process);
 		MUtils::OS::change_process_priority(&process, m_preferences->getProcessPriority());
-		lock.unlock();
 		return true;
 	}
 
@@ -204,6 +211,31 @@ bool AbstractTool::startProcess(QProcess &process, const QString &program, const
 	return false;
 }
 
+bool AbstractTool::launchProcess(QProcess &process, const QString &program, const QStringList &args, JobObject *const jobObject)
+{
+	/*
+	 * Process creation itself remains serialized: Qt 4 creates the pipes of the child as inheritable handles and
+	 * calls CreateProcess() with handle inheritance inside of start(), offering no way to pass an explicit handle
+	 * list. Without the lock, a concurrently started process could inherit (and keep open) the pipes of another
+	 * one. Only the work that doesn't depend on this, such as job assignment and priority, runs outside the lock.
+	 */
+	{
+		QMutexLocker lock(&s_mutexStartProcess);
+		process.start(program, args);
+	}
+
+	if(process.waitForStarted())
+	{
+		if(jobObject)
+		{
+			jobObject->addProcessToJob(&process);
+		}
+		return true;
+	}
+
+	return false;
+}
+
 // ------------------------------------------------------------
 // Utilities
 // ------------------------------------------------------------
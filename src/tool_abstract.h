@@ -53,6 +53,8 @@ public:
 	virtual bool isVersionSupported(const unsigned int &revision, const bool &modified) = 0;
 	virtual QString printVersion(const unsigned int &revision, const bool &modified) = 0;
 
+	static bool launchProcess(QProcess &process, const QString &program, const QStringList &args, JobObject *const jobObject);
+
 signals:
 	void statusChanged(const JobStatus &newStatus);
 	void progressChanged(unsigned int newProgress);
@@ -67,6 +69,7 @@ protected:
 	virtual QString getBinaryPath(void) const = 0;
 	virtual QHash<QString, QString> getExtraEnv(void) const { return QHash<QString, QString>(); }
 	virtual QStringList getExtraPaths(void) const { return QStringList(); }
+	virtual QStringList getVersionDependencies(void) const { return QStringList(); }
 
 	virtual void checkVersion_init(QList<QRegExp*> &patterns, QStringList &cmdLine) = 0;
 	virtual void checkVersion_parseLine(const QString &line, const QList<QRegExp*> &patterns, unsigned int &core, unsigned int &build, bool &modified) = 0;
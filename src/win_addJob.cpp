@@ -29,6 +29,7 @@
 #include "model_sysinfo.h"
 #include "model_recently.h"
 #include "encoder_factory.h"
+#include "encoder_schema.h"
 #include "mediainfo.h"
 #include "string_validator.h"
 #include "win_help.h"
@@ -54,6 +55,7 @@
 #include <QAction>
 #include <QClipboard>
 #include <QToolTip>
+#include <QtConcurrentRun>
 
 #include <memory>
 
@@ -127,7 +129,9 @@ AddJobDialog::AddJobDialog(QWidget *parent, OptionsModel *const options, Recentl
 	m_preferences(preferences),
 	m_defaults(new OptionsModel(sysinfo)),
 	ui(new Ui::AddJobDialog()),
-	m_monitorConfigChanges(false)
+	m_monitorConfigChanges(false),
+	m_encoderValidator(NULL),
+	m_schemaWatcher(new QFutureWatcher<QSharedPointer<const EncoderSchema> >())
 {
 	//Init the dialog, from the .ui file
 	ui->setupUi(this);
@@ -165,7 +169,7 @@ AddJobDialog::AddJobDialog(QWidget *parent, OptionsModel *const options, Recentl
 
 	//Setup validator
 	ui->editCustomX264Params->installEventFilter(this);
-	ui->editCustomX264Params->setValidator(new StringValidatorEncoder(ui->labelNotificationX264, ui->iconNotificationX264));
+	ui->editCustomX264Params->setValidator(m_encoderValidator = new StringValidatorEncoder(ui->labelNotificationX264, ui->iconNotificationX264));
 	ui->editCustomX264Params->clear();
 	ui->editCustomAvs2YUVParams->installEventFilter(this);
 	ui->editCustomAvs2YUVParams->setValidator(new StringValidatorSource(ui->labelNotificationAvs2YUV, ui->iconNotificationAvs2YUV));
@@ -198,12 +202,19 @@ AddJobDialog::AddJobDialog(QWidget *parent, OptionsModel *const options, Recentl
 	ADD_CONTEXTMENU_ACTION(ui->editCustomX264Params, QIcon(":/buttons/page_paste.png"), tr("Paste from Clipboard"), pasteActionTriggered);
 	ADD_CONTEXTMENU_ACTION(ui->editCustomAvs2YUVParams, QIcon(":/buttons/page_paste.png"), tr("Paste from Clipboard"), pasteActionTriggered);
 
+	//Validate custom parameters against the options supported by the selected encoder binary
+	connect(ui->cbxEncoderType, SIGNAL(currentIndexChanged(int)), this, SLOT(updateEncoderSchema()));
+	connect(ui->cbxEncoderArch, SIGNAL(currentIndexChanged(int)), this, SLOT(updateEncoderSchema()));
+	connect(ui->cbxEncoderVariant, SIGNAL(currentIndexChanged(int)), this, SLOT(updateEncoderSchema()));
+	connect(m_schemaWatcher.data(), SIGNAL(finished()), this, SLOT(updateEncoderSchema()));
+
 	//Setup template selector
 	loadTemplateList();
 	connect(ui->cbxTemplate, SIGNAL(currentIndexChanged(int)), this, SLOT(templateSelected()));
 
 	//Force initial UI update
 	encoderIndexChanged(ui->cbxEncoderType->currentIndex());
+	updateEncoderSchema();
 	m_monitorConfigChanges = true;
 }
 
@@ -607,6 +618,31 @@ void AddJobDialog::configurationChanged(void)
 	}
 }
 
+void AddJobDialog::updateEncoderSchema(void)
+{
+	const OptionsModel::EncType encType = static_cast<OptionsModel::EncType>(ui->cbxEncoderType->itemData(ui->cbxEncoderType->currentIndex()).toInt());
+	const AbstractEncoderInfo &encoderInfo = EncoderFactory::getEncoderInfo(encType);
+	const quint32 encArch = ui->cbxEncoderArch->itemData(ui->cbxEncoderArch->currentIndex()).toUInt();
+	const quint32 encVariant = ui->cbxEncoderVariant->itemData(ui->cbxEncoderVariant->currentIndex()).toUInt();
+	const QString binaryPath = encoderInfo.getBinaryPath(m_sysinfo, encArch, encVariant);
+
+	//Use the cached schema, if available; the validator stays permissive until it is known
+	const QSharedPointer<const EncoderSchema> schema = EncoderSchema::lookup(binaryPath);
+	m_encoderValidator->setSchema(schema);
+
+	//Re-validate the current input, so that the notification reflects the new schema
+	QString input = ui->editCustomX264Params->text();
+	int pos = ui->editCustomX264Params->cursorPosition();
+	m_encoderValidator->validate(input, pos);
+
+	//Build the schema in the background (only one attempt per binary)
+	if(schema.isNull() && (!m_schemaWatcher->isRunning()) && (!m_schemaAttempted.contains(binaryPath, Qt::CaseInsensitive)))
+	{
+		m_schemaAttempted << binaryPath;
+		m_schemaWatcher->setFuture(QtConcurrent::run(EncoderSchema::build, binaryPath, encoderInfo.getHelpCommand()));
+	}
+}
+
 void AddJobDialog::templateSelected(void)
 {
 	const OptionsModel* options = reinterpret_cast<const OptionsModel*>(ui->cbxTemplate->itemData(ui->cbxTemplate->currentIndex()).value<const void*>());
@@ -22,12 +22,18 @@
 #pragma once
 
 #include <QDialog>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QFutureWatcher>
 
 class OptionsModel;
 class RecentlyUsed;
 class SysinfoModel;
 class PreferencesModel;
 class AbstractEncoderInfo;
+class EncoderSchema;
+class StringValidatorEncoder;
 class QComboBox;
 
 namespace Ui
@@ -86,6 +92,7 @@ private slots:
 	void editorActionTriggered(void);
 	void copyActionTriggered(void);
 	void pasteActionTriggered(void);
+	void updateEncoderSchema(void);
 	
 	virtual void accept(void);
 
@@ -94,6 +101,10 @@ private:
 	bool m_monitorConfigChanges;
 	QString m_lastTemplateName;
 
+	StringValidatorEncoder *m_encoderValidator;
+	QScopedPointer<QFutureWatcher<QSharedPointer<const EncoderSchema> > > m_schemaWatcher;
+	QStringList m_schemaAttempted;
+
 	void loadTemplateList(void);
 	void restoreOptions(const OptionsModel *options);
 	void saveOptions(OptionsModel *options);
@@ -32,15 +32,18 @@
 #include "model_options.h"
 #include "model_preferences.h"
 #include "model_recently.h"
+#include "cache_digest.h"
 #include "thread_avisynth.h"
 #include "thread_binaries.h"
 #include "thread_vapoursynth.h"
 #include "thread_encode.h"
 #include "thread_ipc_recv.h"
+#include "thread_index.h"
 #include "input_filter.h"
 #include "win_addJob.h"
 #include "win_about.h"
 #include "win_preferences.h"
+#include "win_search.h"
 #include "win_updater.h"
 #include "resource.h"
 
@@ -72,6 +75,10 @@
 #include <QSystemTrayIcon>
 #include <QMovie>
 #include <QTextDocument>
+#include <QtConcurrentRun>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QInputDialog>
 #include <ctime>
 
 //Constants
@@ -87,12 +94,26 @@ static const int   vsynth_rev = 57;
 #define SET_FONT_BOLD(WIDGET,BOLD) do { QFont _font = WIDGET->font(); _font.setBold(BOLD); WIDGET->setFont(_font); } while(0)
 #define SET_TEXT_COLOR(WIDGET,COLOR) do { QPalette _palette = WIDGET->palette(); _palette.setColor(QPalette::WindowText, (COLOR)); _palette.setColor(QPalette::Text, (COLOR)); WIDGET->setPalette(_palette); } while(0)
 #define LINK(URL) (QString("<a href=\"%1\">%1</a>").arg((URL)))
-#define INIT_ERROR_EXIT() do { close(); qApp->exit(-1); return; } while(0)
+#define INIT_ERROR_EXIT() do { QThreadPool::globalInstance()->waitForDone(); close(); qApp->exit(-1); return; } while(0)
 #define SETUP_WEBLINK(OBJ, URL) do { (OBJ)->setData(QVariant(QUrl(URL))); connect((OBJ), SIGNAL(triggered()), this, SLOT(showWebLink())); } while(0)
 #define APP_IS_READY (m_initialized && (!m_fileTimer->isActive()) && (QApplication::activeModalWidget() == NULL))
 #define ENSURE_APP_IS_READY() do { if(!APP_IS_READY) { MUtils::Sound::beep(MUtils::Sound::BEEP_WRN); qWarning("Cannot perfrom this action at this time!"); return; } } while(0)
 #define X264_STRCMP(X,Y) ((X).compare((Y), Qt::CaseInsensitive) == 0)
 
+//Wait for a background check to complete, while the main window stays responsive (actions are rejected until initialized)
+static bool waitForResult(const QFuture<bool> &future)
+{
+	if(!future.isFinished())
+	{
+		QEventLoop loop;
+		QFutureWatcher<bool> watcher;
+		QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+		watcher.setFuture(future);
+		loop.exec();
+	}
+	return future.result();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Constructor & Destructor
 ///////////////////////////////////////////////////////////////////////////////
@@ -109,8 +130,10 @@ MainWindow::MainWindow(const MUtils::CPUFetaures::cpu_info_t &cpuFeatures, MUtil
 	m_pendingFiles(new QStringList()),
 	m_preferences(NULL),
 	m_recentlyUsed(NULL),
+	m_pendingLogLine(-1),
 	m_postOperation(POST_OP_DONOTHING),
 	m_initialized(false),
+	m_initializing(false),
 	ui(new Ui::MainWindow())
 {
 	//Init the dialog, from the .ui file
@@ -121,6 +144,7 @@ MainWindow::MainWindow(const MUtils::CPUFetaures::cpu_info_t &cpuFeatures, MUtil
 	qRegisterMetaType<QUuid>("QUuid");
 	qRegisterMetaType<QUuid>("DWORD");
 	qRegisterMetaType<JobStatus>("JobStatus");
+	qRegisterMetaType<JobStatistics>("JobStatistics");
 
 	//Create and initialize the sysinfo object
 	m_sysinfo.reset(new SysinfoModel());
@@ -162,7 +186,7 @@ MainWindow::MainWindow(const MUtils::CPUFetaures::cpu_info_t &cpuFeatures, MUtil
 	}
 	
 	//Create model
-	m_jobList.reset(new JobListModel(m_preferences.data()));
+	m_jobList.reset(new JobListModel(m_preferences.data(), m_sysinfo.data()));
 	connect(m_jobList.data(), SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(jobChangedData(QModelIndex, QModelIndex)));
 	ui->jobsView->setModel(m_jobList.data());
 	
@@ -216,6 +240,12 @@ MainWindow::MainWindow(const MUtils::CPUFetaures::cpu_info_t &cpuFeatures, MUtil
 	connect(ui->actionJob_Browse,   SIGNAL(triggered()),   this, SLOT(browseButtonPressed()   ));
 	connect(ui->actionJob_MoveUp,   SIGNAL(triggered()),   this, SLOT(moveButtonPressed()     ));
 	connect(ui->actionJob_MoveDown, SIGNAL(triggered()),   this, SLOT(moveButtonPressed()     ));
+	connect(ui->actionJob_Interactive, SIGNAL(triggered(bool)), this, SLOT(interactiveActionToggled(bool)));
+	connect(ui->actionJob_IoDefault,   SIGNAL(triggered()),     this, SLOT(ioClassActionTriggered()));
+	connect(ui->actionJob_IoNormal,    SIGNAL(triggered()),     this, SLOT(ioClassActionTriggered()));
+	connect(ui->actionJob_IoLow,       SIGNAL(triggered()),     this, SLOT(ioClassActionTriggered()));
+	connect(ui->actionJob_IoVeryLow,   SIGNAL(triggered()),     this, SLOT(ioClassActionTriggered()));
+	connect(ui->actionJob_IoBandwidth, SIGNAL(triggered()),     this, SLOT(ioBandwidthActionTriggered()));
 
 	//Enable menu
 	connect(ui->actionOpen,             SIGNAL(triggered()), this, SLOT(openActionTriggered()));
@@ -226,10 +256,15 @@ MainWindow::MainWindow(const MUtils::CPUFetaures::cpu_info_t &cpuFeatures, MUtil
 	connect(ui->actionPostOp_Hibernate, SIGNAL(triggered()), this, SLOT(postOpActionTriggered()));
 	connect(ui->actionAbout,            SIGNAL(triggered()), this, SLOT(showAbout()));
 	connect(ui->actionPreferences,      SIGNAL(triggered()), this, SLOT(showPreferences()));
+	connect(ui->actionSearchLogs,       SIGNAL(triggered()), this, SLOT(showSearch()));
 	connect(ui->actionCheckForUpdates,  SIGNAL(triggered()), this, SLOT(checkUpdates()));
 	ui->actionCleanup_Finished->setData(QVariant(bool(0)));
 	ui->actionCleanup_Enqueued->setData(QVariant(bool(1)));
 	ui->actionPostOp_DoNothing->setData(QVariant(POST_OP_DONOTHING));
+	ui->actionJob_IoDefault->setData(QVariant(JobDescriptor::IO_PRIORITY_DEFAULT));
+	ui->actionJob_IoNormal->setData(QVariant(0));
+	ui->actionJob_IoLow->setData(QVariant(-1));
+	ui->actionJob_IoVeryLow->setData(QVariant(-2));
 	ui->actionPostOp_PowerDown->setData(QVariant(POST_OP_POWERDOWN));
 	ui->actionPostOp_Hibernate->setData(QVariant(POST_OP_HIBERNATE));
 	ui->actionPostOp_Hibernate->setEnabled(MUtils::OS::is_hibernation_supported());
@@ -308,6 +343,10 @@ MainWindow::MainWindow(const MUtils::CPUFetaures::cpu_info_t &cpuFeatures, MUtil
 	//Create timer
 	m_fileTimer.reset(new QTimer(this));
 	connect(m_fileTimer.data(), SIGNAL(timeout()), this, SLOT(handlePendingFiles()));
+
+	//Create background indexer
+	m_indexThread.reset(new IndexThread());
+	m_indexThread->start(QThread::LowestPriority);
 }
 
 /*
@@ -327,6 +366,16 @@ MainWindow::~MainWindow(void)
 		}
 	}
 
+	if(!m_indexThread.isNull())
+	{
+		m_indexThread->stop();
+		if(!m_indexThread->wait(5000))
+		{
+			m_indexThread->terminate();
+			m_indexThread->wait();
+		}
+	}
+
 	delete ui;
 }
 
@@ -342,7 +391,7 @@ void MainWindow::addButtonPressed()
 	ENSURE_APP_IS_READY();
 
 	qDebug("MainWindow::addButtonPressed");
-	bool runImmediately = (countRunningJobs() < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
+	bool runImmediately = (countRunningJobs(false) < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
 	QString sourceFileName, outputFileName;
 
 	if(createJob(sourceFileName, outputFileName, m_options.data(), runImmediately))
@@ -369,7 +418,7 @@ void MainWindow::openActionTriggered()
 		}
 		else
 		{
-			bool runImmediately = (countRunningJobs() < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
+			bool runImmediately = (countRunningJobs(false) < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
 			QString sourceFileName(fileList.first()), outputFileName;
 			if(createJob(sourceFileName, outputFileName, m_options.data(), runImmediately))
 			{
@@ -553,6 +602,73 @@ void MainWindow::pauseButtonPressed(bool checked)
 	}
 }
 
+/*
+ * The "interactive" action was toggled
+ */
+void MainWindow::interactiveActionToggled(bool checked)
+{
+	if(!APP_IS_READY)
+	{
+		MUtils::Sound::beep(MUtils::Sound::BEEP_WRN);
+		qWarning("Cannot perfrom this action at this time!");
+		ui->actionJob_Interactive->setChecked(!checked);
+		return;
+	}
+
+	if(!m_jobList->setJobInteractive(ui->jobsView->currentIndex(), checked))
+	{
+		MUtils::Sound::beep(MUtils::Sound::BEEP_ERR);
+		ui->actionJob_Interactive->setChecked(!checked);
+	}
+}
+
+/*
+ * One of the "I/O priority" actions was triggered
+ */
+void MainWindow::ioClassActionTriggered(void)
+{
+	ENSURE_APP_IS_READY();
+
+	const QModelIndex index = ui->jobsView->currentIndex();
+	int ioPriority, ioBandwidthLimit;
+	QAction *const sender = dynamic_cast<QAction*>(QObject::sender());
+	if(sender && m_jobList->getJobIoClass(index, ioPriority, ioBandwidthLimit))
+	{
+		const QVariant data = sender->data();
+		if(data.isValid() && (data.type() == QVariant::Int) && m_jobList->setJobIoClass(index, data.toInt(), ioBandwidthLimit))
+		{
+			updateButtons(m_jobList->getJobStatus(index));
+			return;
+		}
+	}
+
+	MUtils::Sound::beep(MUtils::Sound::BEEP_ERR);
+	updateButtons(m_jobList->getJobStatus(index));
+}
+
+/*
+ * The "I/O bandwidth limit" action was triggered
+ */
+void MainWindow::ioBandwidthActionTriggered(void)
+{
+	ENSURE_APP_IS_READY();
+
+	const QModelIndex index = ui->jobsView->currentIndex();
+	int ioPriority, ioBandwidthLimit;
+	if(!m_jobList->getJobIoClass(index, ioPriority, ioBandwidthLimit))
+	{
+		MUtils::Sound::beep(MUtils::Sound::BEEP_ERR);
+		return;
+	}
+
+	bool ok = false;
+	const int value = QInputDialog::getInt(this, tr("I/O Bandwidth Limit"), tr("Bandwidth limit of this job, in MB/s (0 = Unlimited, -1 = Use Preferences):"), ioBandwidthLimit, JobDescriptor::IO_BANDWIDTH_DEFAULT, 4096, 1, &ok);
+	if(ok && (!m_jobList->setJobIoClass(index, ioPriority, value)))
+	{
+		MUtils::Sound::beep(MUtils::Sound::BEEP_ERR);
+	}
+}
+
 /*
  * The "restart" button was clicked
  */
@@ -567,7 +683,7 @@ void MainWindow::restartButtonPressed(void)
 
 	if((options) && (!sourceFileName.isEmpty()) && (!outputFileName.isEmpty()))
 	{
-		bool runImmediately = (countRunningJobs() < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
+		bool runImmediately = (countRunningJobs(false) < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
 		OptionsModel *tempOptions = new OptionsModel(*options);
 		if(createJob(sourceFileName, outputFileName, tempOptions, runImmediately, true))
 		{
@@ -597,7 +713,7 @@ void MainWindow::jobSelected(const QModelIndex & current, const QModelIndex & pr
 		{
 			action->setEnabled(true);
 		}
-		QTimer::singleShot(0, ui->logView, SLOT(scrollToBottom()));
+		QTimer::singleShot(0, this, SLOT(showPendingLogLine()));
 
 		ui->progressBar->setValue(m_jobList->getJobProgress(current));
 		ui->editDetails->setText(m_jobList->data(m_jobList->index(current.row(), 3, QModelIndex()), Qt::DisplayRole).toString());
@@ -617,6 +733,16 @@ void MainWindow::jobSelected(const QModelIndex & current, const QModelIndex & pr
 		updateTaskbar(JobStatus_Undefined, QIcon());
 	}
 
+	//Unload the previous log only after it has been detached from the view
+	if(previous.isValid() && (previous.row() != current.row()))
+	{
+		const JobStatus status = m_jobList->getJobStatus(previous);
+		if((status == JobStatus_Completed) || (status == JobStatus_Failed) || (status == JobStatus_Aborted))
+		{
+			m_jobList->getLogFile(previous)->unload();
+		}
+	}
+
 	ui->progressBar->repaint();
 }
 
@@ -642,6 +768,11 @@ void MainWindow::jobChangedData(const QModelIndex &topLeft, const  QModelIndex &
 			{
 				if(m_preferences->getAutoRunNextJob()) QTimer::singleShot(0, this, SLOT(launchNextJob()));
 				if(m_preferences->getSaveLogFiles()) saveLogFile(m_jobList->index(i, 1, QModelIndex()));
+				if(i != selected) m_jobList->getLogFile(m_jobList->index(i, 0, QModelIndex()))->unload();
+			}
+			else if(status == JobStatus_Finalizing)
+			{
+				if(m_preferences->getAutoRunNextJob()) QTimer::singleShot(0, this, SLOT(launchNextJob()));
 			}
 		}
 	}
@@ -678,7 +809,57 @@ void MainWindow::jobChangedData(const QModelIndex &topLeft, const  QModelIndex &
  */
 void MainWindow::jobLogExtended(const QModelIndex & parent, int start, int end)
 {
-	QTimer::singleShot(0, ui->logView, SLOT(scrollToBottom()));
+	//Only follow the log, if the user has not scrolled up (the scroll range is updated lazily)
+	const QScrollBar *const scrollBar = ui->logView->verticalScrollBar();
+	if(scrollBar->value() >= scrollBar->maximum())
+	{
+		QTimer::singleShot(0, ui->logView, SLOT(scrollToBottom()));
+	}
+}
+
+/*
+ * Jump to a line in the log of the given job
+ */
+void MainWindow::jumpToLogLine(const QUuid &jobId, const int &line)
+{
+	const QModelIndex index = m_jobList->getJobIndexById(jobId);
+	if(!index.isValid())
+	{
+		return;
+	}
+
+	m_pendingLogLine = line;
+	if(ui->jobsView->currentIndex().row() != index.row())
+	{
+		ui->jobsView->selectRow(index.row());
+		ui->jobsView->scrollTo(ui->jobsView->currentIndex(), QAbstractItemView::PositionAtCenter);
+	}
+	else
+	{
+		showPendingLogLine();
+	}
+}
+
+/*
+ * Scroll log to the requested line, or to the bottom
+ */
+void MainWindow::showPendingLogLine(void)
+{
+	const int line = m_pendingLogLine;
+	m_pendingLogLine = -1;
+
+	if(QAbstractItemModel *const log = ui->logView->model())
+	{
+		if((line >= 0) && (line < log->rowCount(QModelIndex())))
+		{
+			const QModelIndex index = log->index(line, 0, QModelIndex());
+			ui->logView->setCurrentIndex(index);
+			ui->logView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+			return;
+		}
+	}
+
+	ui->logView->scrollToBottom();
 }
 
 /*
@@ -725,6 +906,27 @@ void MainWindow::showPreferences(void)
 	preferences->exec();
 
 	MUTILS_DELETE(preferences);
+	m_jobList->updateIoClasses();
+	m_jobList->updateLookAhead();
+	m_jobList->archiveJobs();
+}
+
+/*
+ * Search logs
+ */
+void MainWindow::showSearch(void)
+{
+	ENSURE_APP_IS_READY();
+
+	if(m_searchDialog.isNull())
+	{
+		m_searchDialog.reset(new SearchDialog(this, m_jobList.data()));
+		connect(m_searchDialog.data(), SIGNAL(jumpToLine(QUuid, int)), this, SLOT(jumpToLogLine(QUuid, int)));
+	}
+
+	m_searchDialog->show();
+	m_searchDialog->raise();
+	m_searchDialog->activateWindow();
 }
 
 /*
@@ -734,7 +936,7 @@ void MainWindow::launchNextJob(void)
 {
 	qDebug("Launching next job...");
 
-	if(countRunningJobs() >= m_preferences->getMaxRunningJobCount())
+	if(countRunningJobs(false) >= m_preferences->getMaxRunningJobCount())
 	{
 		qDebug("Still have too many jobs running, won't launch next one yet!");
 		return;
@@ -883,23 +1085,45 @@ void MainWindow::shutdownComputer(void)
  */
 void MainWindow::init(void)
 {
-	if(m_initialized)
+	if(m_initialized || m_initializing)
 	{
 		qWarning("Already initialized -> skipping!");
 		return;
 	}
 
+	//User input is processed while waiting for the checks, so the window may be shown again in the meantime
+	m_initializing = true;
+
 	updateLabelPos();
 	const MUtils::OS::ArgumentMap &arguments = MUtils::OS::arguments();
 	qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
 
+	//---------------------------------------
+	// Start environment detection
+	//---------------------------------------
+
+	//Cached digests are ignored, if a full verification was requested
+	if(arguments.contains(CLI_PARAM_FULL_VERIFICATION))
+	{
+		qWarning("Full verification of all tools has been requested!\n");
+		DigestCache::setFullVerification(true);
+	}
+
+	//All checks run concurrently, results are evaluated below (in the original order)
+	QString failedPath;
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	const QFuture<bool> binariesCheck = QtConcurrent::run(BinariesCheckThread::check, static_cast<const SysinfoModel*>(m_sysinfo.data()), &failedPath);
+	const QFuture<bool> avisynthCheck = arguments.contains(CLI_PARAM_SKIP_AVS_CHECK) ? QFuture<bool>() : QtConcurrent::run(AvisynthCheckThread::detect, m_sysinfo.data());
+	const QFuture<bool> vapoursynthCheck = arguments.contains(CLI_PARAM_SKIP_VPS_CHECK) ? QFuture<bool>() : QtConcurrent::run(VapourSynthCheckThread::detect, m_sysinfo.data());
+
 	//---------------------------------------
 	// Check required binaries
 	//---------------------------------------
 		
 	qDebug("[Validating binaries]");
-	QString failedPath;
-	if(!BinariesCheckThread::check(m_sysinfo.data(), &failedPath))
+	const bool binariesValid = waitForResult(binariesCheck);
+	QApplication::restoreOverrideCursor();
+	if(!binariesValid)
 	{
 		QMessageBox::critical(this, tr("Invalid File!"), tr("<nobr>At least one tool is missing or is not a valid Win32/Win64 binary:</nobr><br><tt>%1</tt><br><br><nobr>Please re-install the program in order to fix the problem!</nobr>").replace("-", "&minus;").arg(Qt::escape(QDir::toNativeSeparators(failedPath))));
 		qFatal("At least one tool is missing or is not a valid Win32/Win64 binary. Program will exit now!");
@@ -978,7 +1202,10 @@ void MainWindow::init(void)
 	if(!arguments.contains(CLI_PARAM_SKIP_AVS_CHECK))
 	{
 		qDebug("[Check for Avisynth support]");
-		if(!AvisynthCheckThread::detect(m_sysinfo.data()))
+		QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+		const bool avisynthValid = waitForResult(avisynthCheck);
+		QApplication::restoreOverrideCursor();
+		if(!avisynthValid)
 		{
 			QString text = tr("A critical error was encountered while checking your Avisynth version.").append("<br>");
 			text += tr("This is most likely caused by an erroneous Avisynth Plugin, please try to clean your Plugins folder!").append("<br>");
@@ -1007,7 +1234,10 @@ void MainWindow::init(void)
 	if(!arguments.contains(CLI_PARAM_SKIP_VPS_CHECK))
 	{
 		qDebug("[Check for VapourSynth support]");
-		if(!VapourSynthCheckThread::detect(m_sysinfo.data()))
+		QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+		const bool vapoursynthValid = waitForResult(vapoursynthCheck);
+		QApplication::restoreOverrideCursor();
+		if(!vapoursynthValid)
 		{
 			QString text = tr("A critical error was encountered while checking your VapourSynth installation.").append("<br>");
 			text += tr("This is most likely caused by an erroneous VapourSynth Plugin, please try to clean your Filters folder!").append("<br>");
@@ -1053,6 +1283,7 @@ void MainWindow::init(void)
 
 	//Update flag
 	m_initialized = true;
+	m_initializing = false;
 
 	//Hide the spinner animation
 	if(!m_label[1].isNull())
@@ -1116,6 +1347,12 @@ void MainWindow::init(void)
 		}
 	}
 
+	//Re-attach jobs that survived an unexpected termination
+	if(m_jobList->recoverJobs() > 0)
+	{
+		m_label[0]->setVisible(m_jobList->rowCount(QModelIndex()) == 0);
+	}
+
 	//Load queued jobs
 	if(m_jobList->loadQueuedJobs(m_sysinfo.data()) > 0)
 	{
@@ -1182,6 +1419,7 @@ void MainWindow::saveLogToLocalFile(bool checked)
 void MainWindow::toggleLineWrapping(bool checked)
 {
 	ui->logView->setWordWrap(checked);
+	ui->logView->setUniformItemSizes(!checked);
 }
 
 /*
@@ -1260,7 +1498,7 @@ void MainWindow::handleCommand(const int &command, const QStringList &args, cons
 			if(QFileInfo(args[0]).exists() && QFileInfo(args[0]).isFile())
 			{
 				OptionsModel options(m_sysinfo.data());
-				bool runImmediately = (countRunningJobs() < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
+				bool runImmediately = (countRunningJobs(false) < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
 				if(!(args[2].isEmpty() || X264_STRCMP(args[2], "-")))
 				{
 					if(!OptionsModel::loadTemplate(&options, args[2].trimmed()))
@@ -1557,7 +1795,7 @@ bool MainWindow::createJobMultiple(const QStringList &filePathIn)
 	//Add files individually
 	for(iter = filePathIn.constBegin(); (iter != filePathIn.constEnd()) && (!applyToAll); iter++)
 	{
-		runImmediately = (countRunningJobs() < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
+		runImmediately = (countRunningJobs(false) < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
 		QString sourceFileName(*iter), outputFileName;
 		if(createJob(sourceFileName, outputFileName, m_options.data(), runImmediately, false, counter++, filePathIn.count(), &applyToAll))
 		{
@@ -1572,7 +1810,7 @@ bool MainWindow::createJobMultiple(const QStringList &filePathIn)
 	//Add remaining files
 	while(applyToAll && (iter != filePathIn.constEnd()))
 	{
-		const bool runImmediatelyTmp = runImmediately && (countRunningJobs() < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
+		const bool runImmediatelyTmp = runImmediately && (countRunningJobs(false) < (m_preferences->getAutoRunNextJob() ? m_preferences->getMaxRunningJobCount() : 1));
 		const QString sourceFileName = *iter;
 		const QString outputFileName = AddJobDialog::generateOutputFileName(sourceFileName, m_recentlyUsed->outputDirectory(), m_recentlyUsed->filterIndex(), m_preferences->getSaveToSourcePath());
 		if(!appendJob(sourceFileName, outputFileName, m_options.data(), runImmediatelyTmp))
@@ -1591,8 +1829,8 @@ bool MainWindow::createJobMultiple(const QStringList &filePathIn)
 bool MainWindow::appendJob(const QString &sourceFileName, const QString &outputFileName, OptionsModel *options, const bool runImmediately)
 {
 	bool okay = false;
-	EncodeThread *thrd = new EncodeThread(sourceFileName, outputFileName, options, m_sysinfo.data(), m_preferences.data());
-	QModelIndex newIndex = m_jobList->insertJob(thrd);
+	const JobDescriptor job(sourceFileName, outputFileName, options);
+	QModelIndex newIndex = m_jobList->insertJob(job);
 
 	if(newIndex.isValid())
 	{
@@ -1602,6 +1840,15 @@ bool MainWindow::appendJob(const QString &sourceFileName, const QString &outputF
 			QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 			m_jobList->startJob(newIndex);
 		}
+		else
+		{
+			QString program, indexFile;
+			QStringList args;
+			if(job.getIndexCommand(m_sysinfo.data(), m_preferences.data(), program, args, indexFile))
+			{
+				m_indexThread->enqueue(program, args, indexFile); /*index in the background, while the job is waiting*/
+			}
+		}
 
 		okay = true;
 	}
@@ -1631,9 +1878,9 @@ unsigned int MainWindow::countPendingJobs(void)
 }
 
 /*
- * Jobs that are still active, i.e. not terminated or enqueued
+ * Jobs that are still active, i.e. not terminated or enqueued (copying the output does not count)
  */
-unsigned int MainWindow::countRunningJobs(void)
+unsigned int MainWindow::countRunningJobs(const bool &countFinalizing)
 {
 	unsigned int count = 0;
 	const int rows = m_jobList->rowCount(QModelIndex());
@@ -1641,7 +1888,7 @@ unsigned int MainWindow::countRunningJobs(void)
 	for(int i = 0; i < rows; i++)
 	{
 		JobStatus status = m_jobList->getJobStatus(m_jobList->index(i, 0, QModelIndex()));
-		if(status != JobStatus_Completed && status != JobStatus_Aborted && status != JobStatus_Failed && status != JobStatus_Enqueued)
+		if(status != JobStatus_Completed && status != JobStatus_Aborted && status != JobStatus_Failed && status != JobStatus_Enqueued && (countFinalizing || (status != JobStatus_Finalizing)))
 		{
 			count++;
 		}
@@ -1658,7 +1905,7 @@ void MainWindow::updateButtons(JobStatus status)
 	qDebug("MainWindow::updateButtons(void)");
 
 	ui->buttonStartJob->setEnabled(status == JobStatus_Enqueued);
-	ui->buttonAbortJob->setEnabled(status == JobStatus_Indexing || status == JobStatus_Running || status == JobStatus_Running_Pass1 || status == JobStatus_Running_Pass2 || status == JobStatus_Paused);
+	ui->buttonAbortJob->setEnabled(status == JobStatus_Indexing || status == JobStatus_Running || status == JobStatus_Running_Pass1 || status == JobStatus_Running_Pass2 || status == JobStatus_Paused || status == JobStatus_Finalizing);
 	ui->buttonPauseJob->setEnabled(status == JobStatus_Indexing || status == JobStatus_Running || status == JobStatus_Paused || status == JobStatus_Running_Pass1 || status == JobStatus_Running_Pass2);
 	ui->buttonPauseJob->setChecked(status == JobStatus_Paused || status == JobStatus_Pausing);
 
@@ -1667,6 +1914,20 @@ void MainWindow::updateButtons(JobStatus status)
 	ui->actionJob_Browse->setEnabled(status == JobStatus_Completed);
 	ui->actionJob_MoveUp->setEnabled(status != JobStatus_Undefined);
 	ui->actionJob_MoveDown->setEnabled(status != JobStatus_Undefined);
+	ui->actionJob_Interactive->setEnabled(status != JobStatus_Undefined);
+	ui->actionJob_Interactive->setChecked(m_jobList->getJobInteractive(ui->jobsView->currentIndex()));
+
+	int ioPriority = JobDescriptor::IO_PRIORITY_DEFAULT, ioBandwidthLimit = JobDescriptor::IO_BANDWIDTH_DEFAULT;
+	const bool hasIoClass = m_jobList->getJobIoClass(ui->jobsView->currentIndex(), ioPriority, ioBandwidthLimit);
+	ui->actionJob_IoDefault->setEnabled(hasIoClass);
+	ui->actionJob_IoNormal->setEnabled(hasIoClass);
+	ui->actionJob_IoLow->setEnabled(hasIoClass);
+	ui->actionJob_IoVeryLow->setEnabled(hasIoClass);
+	ui->actionJob_IoBandwidth->setEnabled(hasIoClass);
+	ui->actionJob_IoDefault->setChecked(ioPriority == JobDescriptor::IO_PRIORITY_DEFAULT);
+	ui->actionJob_IoNormal->setChecked(ioPriority ==  0);
+	ui->actionJob_IoLow->setChecked(ioPriority == -1);
+	ui->actionJob_IoVeryLow->setChecked(ioPriority == -2);
 
 	ui->actionJob_Start->setEnabled(ui->buttonStartJob->isEnabled());
 	ui->actionJob_Abort->setEnabled(ui->buttonAbortJob->isEnabled());
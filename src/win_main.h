@@ -40,6 +40,8 @@ class QModelIndex;
 class QLabel;
 class QSystemTrayIcon;
 class IPCThread_Recv;
+class IndexThread;
+class SearchDialog;
 enum JobStatus;
 
 namespace Ui
@@ -86,12 +88,14 @@ private:
 
 	postOp_t m_postOperation;
 	bool m_initialized;
+	bool m_initializing;
 
 	QScopedPointer<QLabel> m_label[2];
 	QScopedPointer<QMovie> m_animation;
 	QScopedPointer<QTimer> m_fileTimer;
 
 	QScopedPointer<IPCThread_Recv>   m_ipcThread;
+	QScopedPointer<IndexThread>      m_indexThread;
 	QScopedPointer<MUtils::Taskbar7> m_taskbar;
 	QScopedPointer<QSystemTrayIcon>  m_sysTray;
 
@@ -106,6 +110,8 @@ private:
 	QScopedPointer<SysinfoModel> m_sysinfo;
 	QScopedPointer<PreferencesModel> m_preferences;
 	QScopedPointer<RecentlyUsed> m_recentlyUsed;
+	QScopedPointer<SearchDialog> m_searchDialog;
+	int m_pendingLogLine;
 	
 	bool createJob(QString &sourceFileName, QString &outputFileName, OptionsModel *options, bool &runImmediately, const bool restart = false, int fileNo = -1, int fileTotal = 0, bool *applyToAll = NULL);
 	bool createJobMultiple(const QStringList &filePathIn);
@@ -114,7 +120,7 @@ private:
 	void updateButtons(JobStatus status);
 	void updateTaskbar(JobStatus status, const QIcon &icon);
 	unsigned int countPendingJobs(void);
-	unsigned int countRunningJobs(void);
+	unsigned int countRunningJobs(const bool &countFinalizing = true);
 
 	bool parseCommandLineArgs(void);
 
@@ -133,9 +139,14 @@ private slots:
 	void handlePendingFiles(void);
 	void init(void);
 	void handleCommand(const int &command, const QStringList &args, const quint32 &flags = 0);
+	void interactiveActionToggled(bool checked);
+	void ioClassActionTriggered(void);
+	void ioBandwidthActionTriggered(void);
 	void jobSelected(const QModelIndex &current, const QModelIndex &previous);
 	void jobChangedData(const  QModelIndex &top, const  QModelIndex &bottom);
 	void jobLogExtended(const QModelIndex & parent, int start, int end);
+	void jumpToLogLine(const QUuid &jobId, const int &line);
+	void showPendingLogLine(void);
 	void jobListKeyPressed(const int &tag);
 	void launchNextJob();
 	void moveButtonPressed(void);
@@ -144,6 +155,7 @@ private slots:
 	void saveLogFile(const QModelIndex &index);
 	void showAbout(void);
 	void showPreferences(void);
+	void showSearch(void);
 	void showWebLink(void);
 	void shutdownComputer(void);
 	void startButtonPressed(void);
@@ -74,6 +74,10 @@ PreferencesDialog::PreferencesDialog(QWidget *parent, PreferencesModel *preferen
 	ui->comboBoxPriority->setItemData(2, QVariant::fromValue(-1)); //Below Normal
 	ui->comboBoxPriority->setItemData(3, QVariant::fromValue(-2)); //Idle
 
+	ui->comboBoxIoPriority->setItemData(0, QVariant::fromValue( 0)); //Normal
+	ui->comboBoxIoPriority->setItemData(1, QVariant::fromValue(-1)); //Low
+	ui->comboBoxIoPriority->setItemData(2, QVariant::fromValue(-2)); //Very Low
+
 	ui->labelRunNextJob        ->installEventFilter(this);
 	ui->labelUse64BitAvs2YUV   ->installEventFilter(this);
 	ui->labelSaveLogFiles      ->installEventFilter(this);
@@ -82,9 +86,15 @@ PreferencesDialog::PreferencesDialog(QWidget *parent, PreferencesModel *preferen
 	ui->labelDisableWarnings   ->installEventFilter(this);
 	ui->labelNoUpdateReminder  ->installEventFilter(this);
 	ui->labelSaveQueueNoConfirm->installEventFilter(this);
+	ui->labelKeepJobsAlive     ->installEventFilter(this);
+	ui->labelStageOutput       ->installEventFilter(this);
+	ui->labelSaveChecksums     ->installEventFilter(this);
 
 	ui->checkBoxDummy1->installEventFilter(this);
 	ui->checkBoxDummy2->installEventFilter(this);
+	ui->checkBoxDummy3->installEventFilter(this);
+	ui->checkBoxDummy4->installEventFilter(this);
+	ui->checkBoxDummy5->installEventFilter(this);
 
 	connect(ui->resetButton, SIGNAL(clicked()), this, SLOT(resetButtonPressed()));
 	connect(ui->checkDisableWarnings, SIGNAL(toggled(bool)), this, SLOT(disableWarningsToggled(bool)));
@@ -109,9 +119,20 @@ void PreferencesDialog::showEvent(QShowEvent *event)
 	UPDATE_CHECKBOX(ui->checkNoUpdateReminder,   m_preferences->getNoUpdateReminder());
 	UPDATE_CHECKBOX(ui->checkDisableWarnings,    m_preferences->getDisableWarnings(), true);
 	UPDATE_CHECKBOX(ui->checkSaveQueueNoConfirm, m_preferences->getSaveQueueNoConfirm());
+	UPDATE_CHECKBOX(ui->checkKeepJobsAlive,      m_preferences->getKeepJobsAlive());
+	UPDATE_CHECKBOX(ui->checkStageOutput,        m_preferences->getStageOutput());
+	UPDATE_CHECKBOX(ui->checkSaveChecksums,      m_preferences->getSaveChecksums());
 	
 	ui->spinBoxJobCount->setValue(m_preferences->getMaxRunningJobCount());
 	UPDATE_COMBOBOX(ui->comboBoxPriority, qBound(-2, m_preferences->getProcessPriority(), 1), 0);
+	UPDATE_COMBOBOX(ui->comboBoxIoPriority, qBound(-2, m_preferences->getIoPriority(), 0), 0);
+	ui->spinBoxIoBandwidth->setValue(m_preferences->getIoBandwidthLimit());
+	ui->spinBoxRenderAheadJobs->setValue(m_preferences->getRenderAheadJobs());
+	ui->spinBoxRenderAheadSpool->setValue(m_preferences->getRenderAheadSpool());
+	ui->spinBoxStageInputJobs->setValue(m_preferences->getStageInputJobs());
+	ui->spinBoxStageInputBudget->setValue(m_preferences->getStageInputBudget());
+	ui->spinBoxArchiveJobsAge->setValue(m_preferences->getArchiveJobsAge());
+	ui->spinBoxArchiveJobsCount->setValue(m_preferences->getArchiveJobsCount());
 	
 	const bool hasX64 = m_sysinfo->getCPUFeatures(SysinfoModel::CPUFeatures_X64);
 	ui->checkUse64BitAvs2YUV->setEnabled(hasX64);
@@ -124,6 +145,9 @@ bool PreferencesDialog::eventFilter(QObject *o, QEvent *e)
 	{
 		if(o == ui->checkBoxDummy1) return true;
 		if(o == ui->checkBoxDummy2) return true;
+		if(o == ui->checkBoxDummy3) return true;
+		if(o == ui->checkBoxDummy4) return true;
+		if(o == ui->checkBoxDummy5) return true;
 	}
 	else if((e->type() == QEvent::MouseButtonPress) || (e->type() == QEvent::MouseButtonRelease))
 	{
@@ -135,6 +159,9 @@ bool PreferencesDialog::eventFilter(QObject *o, QEvent *e)
 		emulateMouseEvent(o, e, ui->labelDisableWarnings,    ui->checkDisableWarnings);
 		emulateMouseEvent(o, e, ui->labelNoUpdateReminder,   ui->checkNoUpdateReminder);
 		emulateMouseEvent(o, e, ui->labelSaveQueueNoConfirm, ui->checkSaveQueueNoConfirm);
+		emulateMouseEvent(o, e, ui->labelKeepJobsAlive,      ui->checkKeepJobsAlive);
+		emulateMouseEvent(o, e, ui->labelStageOutput,        ui->checkStageOutput);
+		emulateMouseEvent(o, e, ui->labelSaveChecksums,      ui->checkSaveChecksums);
 	}
 	return false;
 }
@@ -164,10 +191,21 @@ void PreferencesDialog::done(int n)
 	m_preferences->setSaveToSourcePath  (ui->checkSaveToSourceFolder->isChecked());
 	m_preferences->setMaxRunningJobCount(ui->spinBoxJobCount->value());
 	m_preferences->setProcessPriority   (ui->comboBoxPriority->itemData(ui->comboBoxPriority->currentIndex()).toInt());
+	m_preferences->setIoPriority        (ui->comboBoxIoPriority->itemData(ui->comboBoxIoPriority->currentIndex()).toInt());
+	m_preferences->setIoBandwidthLimit  (ui->spinBoxIoBandwidth->value());
+	m_preferences->setRenderAheadJobs   (ui->spinBoxRenderAheadJobs->value());
+	m_preferences->setRenderAheadSpool  (ui->spinBoxRenderAheadSpool->value());
+	m_preferences->setStageInputJobs    (ui->spinBoxStageInputJobs->value());
+	m_preferences->setStageInputBudget  (ui->spinBoxStageInputBudget->value());
+	m_preferences->setArchiveJobsAge    (ui->spinBoxArchiveJobsAge->value());
+	m_preferences->setArchiveJobsCount  (ui->spinBoxArchiveJobsCount->value());
 	m_preferences->setEnableSounds      (ui->checkEnableSounds->isChecked());
 	m_preferences->setDisableWarnings   (ui->checkDisableWarnings->isChecked());
 	m_preferences->setNoUpdateReminder  (ui->checkNoUpdateReminder->isChecked());
 	m_preferences->setSaveQueueNoConfirm(ui->checkSaveQueueNoConfirm->isChecked());
+	m_preferences->setKeepJobsAlive     (ui->checkKeepJobsAlive->isChecked());
+	m_preferences->setStageOutput       (ui->checkStageOutput->isChecked());
+	m_preferences->setSaveChecksums     (ui->checkSaveChecksums->isChecked());
 
 	PreferencesModel::savePreferences(m_preferences);
 	QDialog::done(n);
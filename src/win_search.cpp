@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#include "win_search.h"
+#include "UIC_win_search.h"
+
+//Internal
+#include "global.h"
+#include "model_jobList.h"
+#include "model_logFile.h"
+#include "model_logIndex.h"
+
+//Qt
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHeaderView>
+
+//The query runs once the user stopped typing for this long
+static const int QUERY_DELAY = 200;
+
+//Only this many hits are listed, the total is still reported
+static const int MAX_RESULTS = 1000;
+
+///////////////////////////////////////////////////////////////////////////////
+// Constructor & Destructor
+///////////////////////////////////////////////////////////////////////////////
+
+SearchDialog::SearchDialog(QWidget *parent, JobListModel *const jobList)
+:
+	QDialog(parent),
+	m_jobList(jobList),
+	m_queryTimer(new QTimer()),
+	ui(new Ui::SearchDialog())
+{
+	//Init the dialog, from the .ui file
+	ui->setupUi(this);
+	setWindowFlags(windowFlags() & (~Qt::WindowContextHelpButtonHint));
+
+	//Fix size
+	setMinimumSize(size());
+
+	//Setup result list
+	ui->treeResults->header()->setResizeMode(0, QHeaderView::ResizeToContents);
+	ui->treeResults->header()->setResizeMode(1, QHeaderView::ResizeToContents);
+	ui->treeResults->header()->setStretchLastSection(true);
+
+	//Setup query
+	m_queryTimer->setSingleShot(true);
+	m_queryTimer->setInterval(QUERY_DELAY);
+	connect(m_queryTimer, SIGNAL(timeout()), this, SLOT(runQuery()));
+	connect(ui->editQuery, SIGNAL(textChanged(QString)), this, SLOT(queryChanged()));
+	connect(ui->editQuery, SIGNAL(returnPressed()), this, SLOT(runQuery()));
+	connect(ui->treeResults, SIGNAL(itemActivated(QTreeWidgetItem*, int)), this, SLOT(resultActivated(QTreeWidgetItem*, int)));
+}
+
+SearchDialog::~SearchDialog(void)
+{
+	delete m_queryTimer;
+	delete ui;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Events
+///////////////////////////////////////////////////////////////////////////////
+
+void SearchDialog::showEvent(QShowEvent *event)
+{
+	QDialog::showEvent(event);
+	ui->editQuery->setFocus();
+	ui->editQuery->selectAll();
+
+	//The logs may have changed while the dialog was hidden
+	if(!ui->editQuery->text().trimmed().isEmpty())
+	{
+		m_queryTimer->start();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Slots
+///////////////////////////////////////////////////////////////////////////////
+
+void SearchDialog::queryChanged(void)
+{
+	m_queryTimer->start();
+}
+
+void SearchDialog::runQuery(void)
+{
+	m_queryTimer->stop();
+	ui->treeResults->clear();
+
+	const QString query = ui->editQuery->text().trimmed();
+	if(query.isEmpty())
+	{
+		ui->labelStatus->clear();
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QList<LogIndex::hit_t> hits;
+	const int total = m_jobList->getLogIndex()->search(query, hits, MAX_RESULTS);
+	const qint64 elapsed = timer.elapsed();
+
+	//Hits are sorted by job, so the text of each log only needs to be looked up once
+	QList<QTreeWidgetItem*> items;
+	for(int first = 0; first < hits.count();)
+	{
+		const QUuid jobId = hits.at(first).jobId;
+		QList<int> rows;
+		int next = first;
+		while((next < hits.count()) && (hits.at(next).jobId == jobId))
+		{
+			rows << hits.at(next++).line;
+		}
+
+		const QModelIndex jobIndex = m_jobList->getJobIndexById(jobId);
+		if(LogFileModel *const logFile = m_jobList->getLogFile(jobIndex))
+		{
+			const QString jobName = m_jobList->data(m_jobList->index(jobIndex.row(), 0, QModelIndex()), Qt::DisplayRole).toString();
+			const QStringList lines = logFile->getLines(rows);
+			for(int i = 0; i < rows.count(); i++)
+			{
+				QTreeWidgetItem *const item = new QTreeWidgetItem();
+				item->setText(0, jobName);
+				item->setText(1, QString::number(rows.at(i) + 1));
+				item->setText(2, lines.at(i).trimmed());
+				item->setToolTip(2, lines.at(i));
+				item->setData(0, Qt::UserRole, jobId.toString());
+				item->setData(1, Qt::UserRole, rows.at(i));
+				items << item;
+			}
+		}
+
+		first = next;
+	}
+
+	ui->treeResults->addTopLevelItems(items);
+	if(total > hits.count())
+	{
+		ui->labelStatus->setText(tr("%1 matching lines in %2 ms, showing the first %3.").arg(QString::number(total), QString::number(elapsed), QString::number(hits.count())));
+	}
+	else
+	{
+		ui->labelStatus->setText(tr("%1 matching lines in %2 ms.").arg(QString::number(total), QString::number(elapsed)));
+	}
+}
+
+void SearchDialog::resultActivated(QTreeWidgetItem *item, int column)
+{
+	if(item)
+	{
+		emit jumpToLine(QUuid(item->data(0, Qt::UserRole).toString()), item->data(1, Qt::UserRole).toInt());
+	}
+}
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2024 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version, but always including the *additional*
+// restrictions defined in the "License.txt" file.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QDialog>
+#include <QUuid>
+
+class JobListModel;
+class QTimer;
+class QTreeWidgetItem;
+
+namespace Ui
+{
+	class SearchDialog;
+}
+
+class SearchDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	SearchDialog(QWidget *parent, JobListModel *const jobList);
+	~SearchDialog(void);
+
+signals:
+	void jumpToLine(const QUuid &jobId, const int &line);
+
+private slots:
+	void queryChanged(void);
+	void runQuery(void);
+	void resultActivated(QTreeWidgetItem *item, int column);
+
+private:
+	Ui::SearchDialog *const ui;
+	JobListModel *const m_jobList;
+	QTimer *const m_queryTimer;
+
+protected:
+	virtual void showEvent(QShowEvent *event);
+};